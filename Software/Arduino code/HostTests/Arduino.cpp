@@ -0,0 +1,3 @@
+#include "Arduino.h"
+
+unsigned long hostMillis = 0;
@@ -0,0 +1,36 @@
+#pragma once
+
+// Just enough of the Arduino core to build the hardware-independent firmware files on a PC.
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+typedef uint8_t byte;
+
+#define PI 3.1415926535897932384626433832795
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+#define PROGMEM
+#define pgm_read_byte(a) (*(const uint8_t*)(a))
+#define pgm_read_word(a) (*(const uint16_t*)(a))
+#define pgm_read_dword(a) (*(const uint32_t*)(a))
+#define pgm_read_float(a) (*(const float*)(a))
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+template <class T, class U> auto min(T a, U b) -> decltype(a + b) { return a < b ? a : b; }
+template <class T, class U> auto max(T a, U b) -> decltype(a + b) { return a > b ? a : b; }
+
+// The tests set the time themselves
+extern unsigned long hostMillis;
+inline unsigned long millis() { return hostMillis; }
+inline unsigned long micros() { return hostMillis * 1000UL; }
+inline int analogRead(uint8_t) { return 1023; }
+
+class String {
+public:
+  String(const char* s = "") {}
+  String(float, unsigned char decimals = 2) {}
+  const char* c_str() const { return ""; }
+  unsigned int length() const { return 0; }
+};
@@ -0,0 +1,49 @@
+#include "EEPROM.h"
+
+EEPROMClass EEPROM;
+
+EEPROMClass::EEPROMClass()
+{
+  reset(EEPROM_MAX_SIZE);
+}
+
+void EEPROMClass::reset(int size)
+{
+  _size = size;
+  memset(_cells, 0xFF, sizeof(_cells));
+  memset(_writes, 0, sizeof(_writes));
+}
+
+uint8_t EEPROMClass::read(int location) const
+{
+  return (location >= 0 && location < _size) ? _cells[location] : 0xFF;
+}
+
+void EEPROMClass::update(int location, uint8_t value)
+{
+  if (read(location) != value)
+  {
+    write(location, value);
+  }
+}
+
+void EEPROMClass::write(int location, uint8_t value)
+{
+  if (location < 0 || location >= _size)
+  {
+    fprintf(stderr, "EEPROM: write to %d is outside the %d bytes\n", location, _size);
+    exit(2);
+  }
+  _cells[location] = value;
+  _writes[location]++;
+}
+
+uint16_t EEPROMClass::length() const
+{
+  return _size;
+}
+
+unsigned long EEPROMClass::writes(int location) const
+{
+  return _writes[location];
+}
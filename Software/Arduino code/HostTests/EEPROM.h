@@ -0,0 +1,29 @@
+#pragma once
+#include <Arduino.h>
+
+// An EEPROM in RAM that counts the writes to every cell.
+#define EEPROM_MAX_SIZE 4096
+
+class EEPROMClass {
+public:
+  EEPROMClass();
+
+  // Erase the cells and clear the counters. size is 4096 for a Mega, 1024 for an Uno.
+  void reset(int size);
+
+  uint8_t read(int location) const;
+  // Like the AVR core, a cell is only written when its value changes.
+  void update(int location, uint8_t value);
+  void write(int location, uint8_t value);
+  uint16_t length() const;
+
+  // Times the cell was written since reset()
+  unsigned long writes(int location) const;
+
+private:
+  int _size;
+  uint8_t _cells[EEPROM_MAX_SIZE];
+  unsigned long _writes[EEPROM_MAX_SIZE];
+};
+
+extern EEPROMClass EEPROM;
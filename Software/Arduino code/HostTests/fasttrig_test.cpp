@@ -0,0 +1,130 @@
+// Checks the FastTrig tables and the fixed point altitude/azimuth conversion against the math library.
+// The firmware's Configuration_adv.hpp must have FAST_TRIG set to 1. The timing half runs on the board,
+// see FAST_TRIG_TIMING.
+#include <math.h>
+#include "../OpenAstroTracker/FastTrig.hpp"
+#include "../OpenAstroTracker/AltAz.hpp"
+
+#if FAST_TRIG != 1
+#error Set FAST_TRIG to 1 in Configuration_adv.hpp to test it
+#endif
+
+static int failures = 0;
+
+static void check(bool ok, const char* what)
+{
+  printf("%s: %s\n", ok ? "ok  " : "FAIL", what);
+  if (!ok)
+  {
+    failures++;
+  }
+}
+
+static double radians(double degrees)
+{
+  return degrees * M_PI / 180.0;
+}
+
+// Angle in degrees between two points on the sphere
+static double separation(double longitude1, double latitude1, double longitude2, double latitude2)
+{
+  double c = sin(radians(latitude1)) * sin(radians(latitude2)) +
+             cos(radians(latitude1)) * cos(radians(latitude2)) * cos(radians(longitude1 - longitude2));
+  return acos(fmin(1.0, fmax(-1.0, c))) * 180.0 / M_PI;
+}
+
+// Altitude and azimuth in double precision
+static void referenceAltAz(double ha, double dec, double latitude, double& altitude, double& azimuth)
+{
+  double x = cos(radians(latitude)) * sin(radians(dec)) - sin(radians(latitude)) * cos(radians(dec)) * cos(radians(ha));
+  double y = -sin(radians(ha)) * cos(radians(dec));
+  double z = sin(radians(latitude)) * sin(radians(dec)) + cos(radians(latitude)) * cos(radians(dec)) * cos(radians(ha));
+  altitude = asin(z) * 180.0 / M_PI;
+  azimuth = atan2(y, x) * 180.0 / M_PI;
+}
+
+static void sineAndCosine()
+{
+  double worst = 0;
+  for (long angle = 0; angle < 65536; angle++)
+  {
+    double radian = angle * 2.0 * M_PI / 65536.0;
+    worst = fmax(worst, fabs(FastTrig::sin(angle) / (double)TRIG_ONE - sin(radian)));
+    worst = fmax(worst, fabs(FastTrig::cos(angle) / (double)TRIG_ONE - cos(radian)));
+  }
+  printf("      sin/cos: largest error %.2e over all 65536 angles\n", worst);
+  check(worst <= 6e-5, "sin and cos within 6e-5");
+}
+
+static void arctangent()
+{
+  // Vectors of every direction and of lengths from a few units up to the 28 bit values AltAz uses
+  double worst = 0;
+  for (long length = 5; length < (1L << 28); length = length * 3 + 1)
+  {
+    for (int step = 0; step < 3600; step++)
+    {
+      double radian = step * 2.0 * M_PI / 3600.0 + 0.0001 * length;
+      long x = lround(length * cos(radian));
+      long y = lround(length * sin(radian));
+      if (x == 0 && y == 0)
+      {
+        continue;
+      }
+      double expected = atan2((double)y, (double)x) * 32768.0 / M_PI;
+      double error = fabs(remainder(FastTrig::atan2(y, x) - expected, 65536.0));
+      // Short vectors are off by their own rounding, only count the table error
+      if (length >= 1000)
+      {
+        worst = fmax(worst, error);
+      }
+    }
+  }
+  printf("      atan2: largest error %.2f units (%.4f degrees)\n", worst, worst * 360.0 / 65536.0);
+  check(worst <= 1.3, "atan2 within 1.3 units");
+  check(FastTrig::atan2(0, 0) == 0, "atan2(0, 0) is 0");
+
+  bool exact = true;
+  for (unsigned long value = 0; value < 20000000UL; value += 997)
+  {
+    exact &= FastTrig::isqrt(value) == (uint16_t)floor(sqrt((double)value));
+  }
+  exact &= FastTrig::isqrt(0xFFFFFFFFUL) == 65535;
+  check(exact, "isqrt rounds down");
+}
+
+static void altAz()
+{
+  double worst = 0;
+  double worstRoundTrip = 0;
+  for (int latitude = -85; latitude <= 85; latitude += 17)
+  {
+    for (int dec = -89; dec <= 89; dec += 4)
+    {
+      for (int ha = -180; ha < 180; ha += 5)
+      {
+        float altitude, azimuth;
+        AltAz::fromEquatorial(ha, dec, latitude, altitude, azimuth);
+        double trueAltitude, trueAzimuth;
+        referenceAltAz(ha, dec, latitude, trueAltitude, trueAzimuth);
+        worst = fmax(worst, separation(azimuth, altitude, trueAzimuth, trueAltitude));
+
+        float backHA, backDEC;
+        AltAz::toEquatorial(altitude, azimuth, latitude, backHA, backDEC);
+        worstRoundTrip = fmax(worstRoundTrip, separation(backHA, backDEC, ha, dec));
+      }
+    }
+  }
+  printf("      AltAz: largest error %.4f degrees, round trip %.4f degrees\n", worst, worstRoundTrip);
+  check(worst <= 0.015, "altitude/azimuth within 0.015 degrees");
+  check(worstRoundTrip <= 0.03, "RA/DEC to altitude/azimuth and back within 0.03 degrees");
+}
+
+int main()
+{
+  sineAndCosine();
+  arctangent();
+  altAz();
+  printf("%s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
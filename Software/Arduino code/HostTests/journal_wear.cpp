@@ -0,0 +1,143 @@
+// Simulates a year of EEPROM traffic of the firmware and reports how many writes the busiest cells get.
+//
+//   journal_wear [EEPROM size]     4096 (Mega, the default) or 1024 (Uno)
+//
+// Every night the mount is powered up, tracks for NIGHT_HOURS with a position checkpoint every
+// POSITION_CHECKPOINT_INTERVAL seconds, slews SLEWS_PER_NIGHT times (each slew invalidates the
+// checkpoint) and has CONFIG_CHANGES_PER_NIGHT config changes written. Fails if a cell would wear
+// out in less than MIN_LIFETIME_YEARS.
+#include "EEPROM.h"
+#include "../OpenAstroTracker/Configuration_adv.hpp"
+#include "../OpenAstroTracker/EPROMStore.hpp"
+#include "../OpenAstroTracker/EPROMJournal.hpp"
+
+#define NIGHTS 365
+#define NIGHT_HOURS 8
+#define SLEWS_PER_NIGHT 30
+#define CONFIG_CHANGES_PER_NIGHT 10
+#define CELL_ENDURANCE 100000UL
+#define MIN_LIFETIME_YEARS 10
+
+// Same size as Mount's PositionCheckpoint, only the size matters to the wear.
+struct Checkpoint {
+  uint8_t marker;
+  uint8_t state;
+  int32_t raPosition;
+  int32_t decPosition;
+  int32_t trkPosition;
+  uint32_t zeroPosRA;
+  uint32_t lst;
+};
+
+static int failures = 0;
+
+static void check(bool ok, const char* what, int night)
+{
+  if (!ok)
+  {
+    printf("FAIL: %s (night %d)\n", what, night);
+    failures++;
+  }
+}
+
+// Busiest cell in [start, end)
+static unsigned long maxWrites(int start, int end, int& location)
+{
+  unsigned long most = 0;
+  for (int i = start; i < end; i++)
+  {
+    if (EEPROM.writes(i) > most)
+    {
+      most = EEPROM.writes(i);
+      location = i;
+    }
+  }
+  return most;
+}
+
+static void report(const char* name, int start, int end)
+{
+  int location = start;
+  unsigned long most = maxWrites(start, end, location);
+  float years = most ? (float)CELL_ENDURANCE / most : 9999.0f;
+  printf("%-12s %4d-%4d  busiest cell %4d: %6lu writes/year, wears out in %.1f years\n", name, start, end - 1, location, most, years);
+  check(years >= MIN_LIFETIME_YEARS, name, NIGHTS);
+}
+
+int main(int argc, char** argv)
+{
+  int size = (argc > 1) ? atoi(argv[1]) : EEPROM_MAX_SIZE;
+  EEPROM.reset(size);
+  EPROMStore::initialize();
+  EPROMStore* store = EPROMStore::Storage();
+
+  unsigned long appends = 0;
+  unsigned long configWrites = 0;
+  int32_t position = 0;
+  Checkpoint last;
+  memset(&last, 0, sizeof(last));
+
+  for (int night = 0; night < NIGHTS; night++)
+  {
+    // Power up, the journal is scanned once like in Mount's constructor.
+    EPROMJournal journal(CONFIG_STORAGE_END, store->length(), sizeof(Checkpoint));
+    journal.begin();
+    if (night > 0)
+    {
+      Checkpoint read;
+      check(journal.read(&read) && memcmp(&read, &last, sizeof(read)) == 0, "journal lost the newest record", night);
+    }
+
+    const long seconds = NIGHT_HOURS * 3600L;
+    long nextSlew = seconds / SLEWS_PER_NIGHT / 2;
+    long nextConfig = seconds / CONFIG_CHANGES_PER_NIGHT / 2;
+    bool valid = false;
+    for (long t = 0; t < seconds; t += POSITION_CHECKPOINT_INTERVAL)
+    {
+      hostMillis += POSITION_CHECKPOINT_INTERVAL * 1000UL;
+      position += 1000;
+
+      if (t >= nextSlew)
+      {
+        // Only the first move after a valid checkpoint writes the invalid record.
+        if (valid)
+        {
+          memset(&last, 0, sizeof(last));
+          journal.append(&last);
+          appends++;
+          valid = false;
+        }
+        nextSlew += seconds / SLEWS_PER_NIGHT;
+        continue;
+      }
+
+      last.marker = 0xC1;
+      last.state = 1;
+      last.raPosition = position;
+      last.decPosition = -position;
+      last.trkPosition = position * 3;
+      last.lst = hostMillis;
+      journal.append(&last);
+      appends++;
+      valid = true;
+
+      if (t >= nextConfig)
+      {
+        store->config().brightness++;
+        store->configChanged();
+        hostMillis += 10000UL;  // Longer than EPROMStore waits for the config to settle
+        store->process();
+        configWrites++;
+        nextConfig += seconds / CONFIG_CHANGES_PER_NIGHT;
+      }
+    }
+  }
+
+  printf("EEPROM of %d bytes, %d nights: %lu journal appends, %lu config writes\n", size, NIGHTS, appends, configWrites);
+  EPROMJournal journal(CONFIG_STORAGE_END, store->length(), sizeof(Checkpoint));
+  printf("Journal holds %d records of %d bytes\n", journal.slots(), (int)sizeof(Checkpoint));
+  report("Config", 0, CONFIG_STORAGE_END);
+  report("Checkpoints", CONFIG_STORAGE_END, size);
+  printf("%s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
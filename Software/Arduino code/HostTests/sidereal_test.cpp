@@ -0,0 +1,88 @@
+// Checks Sidereal against published sidereal times and that advance() keeps the date exact over years.
+#include <math.h>
+#include "../OpenAstroTracker/Sidereal.hpp"
+
+static int failures = 0;
+
+static void check(bool ok, const char* what)
+{
+  printf("%s: %s\n", ok ? "ok  " : "FAIL", what);
+  if (!ok)
+  {
+    failures++;
+  }
+}
+
+// Difference of two times in seconds, across the 24h wrap
+static double secondsApart(double hours, double expected)
+{
+  double diff = fmod(hours - expected + 36.0, 24.0) - 12.0;
+  return fabs(diff) * 3600.0;
+}
+
+static double gmstHours(const JulianDate& date)
+{
+  return Sidereal::gmst(date).raw() * (24.0 / 4294967296.0);
+}
+
+// IAU 1982 GMST in double precision, the reference for the integer implementation
+static double referenceGmst(double daysSinceJ2000)
+{
+  double t = daysSinceJ2000 / 36525.0;
+  double seconds = 67310.54841 + (876600.0 * 3600.0 + 8640184.812866) * t + 0.093104 * t * t - 6.2e-6 * t * t * t;
+  return fmod(fmod(seconds, 86400.0) + 86400.0, 86400.0) / 3600.0;
+}
+
+static void checkGmst(int year, int month, int day, int hour, int minute, double expected, const char* what)
+{
+  double hours = gmstHours(Sidereal::julianDate(year, month, day, hour, minute, 0));
+  printf("      %04d-%02d-%02d %02d:%02d UT: GMST %.6fh, expected %.6fh\n", year, month, day, hour, minute, hours, expected);
+  check(secondsApart(hours, expected) < 0.01, what);
+}
+
+int main()
+{
+  // Meeus, Astronomical Algorithms, example 12.b: 8h34m57.0896s
+  checkGmst(1987, 4, 10, 19, 21, 8.582525, "GMST of the Meeus example");
+  checkGmst(2020, 1, 1, 0, 0, 6.674788, "GMST at 2020-01-01 0h UT");
+
+  JulianDate j2000 = Sidereal::julianDate(2000, 1, 1, 12, 0, 0);
+  check(j2000.days == 0 && j2000.msOfDay == 0, "J2000.0 is day 0");
+
+  // Against the double precision expression from 1950 to 2100
+  double worst = 0;
+  for (int year = 1950; year <= 2100; year += 3)
+  {
+    JulianDate date = Sidereal::julianDate(year, 1 + year % 12, 1 + year % 28, year % 24, year % 60, year % 60);
+    double days = date.days + date.msOfDay / 86400000.0;
+    worst = fmax(worst, secondsApart(gmstHours(date), referenceGmst(days)));
+  }
+  printf("      Largest difference to the double precision GMST: %.4fs\n", worst);
+  check(worst < 0.01, "GMST from 1950 to 2100");
+
+  // Ten years of loop() deltas of up to a minute each must land exactly on the calendar date.
+  JulianDate date = Sidereal::julianDate(2020, 1, 1, 0, 0, 0);
+  JulianDate end = Sidereal::julianDate(2030, 1, 1, 0, 0, 0);
+  unsigned long long remaining = (unsigned long long)(end.days - date.days) * 86400000ULL;
+  unsigned long seed = 12345;
+  while (remaining > 0)
+  {
+    seed = seed * 1103515245UL + 12345UL;
+    unsigned long ms = (seed >> 8) % 60000UL + 1;
+    ms = remaining < ms ? (unsigned long)remaining : ms;
+    Sidereal::advance(date, ms);
+    remaining -= ms;
+  }
+  check(date.days == end.days && date.msOfDay == end.msOfDay, "advance() over ten years in small steps");
+  check(Sidereal::gmst(date) == Sidereal::gmst(end), "GMST after ten years of advance()");
+
+  // The largest step millis() can wrap into
+  date = Sidereal::julianDate(2024, 2, 28, 23, 0, 0);
+  Sidereal::advance(date, 4294967295UL);
+  JulianDate later = Sidereal::julianDate(2024, 4, 18, 16, 2, 47);
+  Sidereal::advance(later, 295);
+  check(date.days == later.days && date.msOfDay == later.msOfDay, "advance() by 2^32 - 1 ms across a leap day");
+
+  printf("%s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,177 @@
+// Follows a low earth orbit satellite pass through the Trajectory ring and checks the spline against the pass,
+// then checks that dropping passed waypoints and refilling the ring does not change the path.
+#include <math.h>
+#include "../OpenAstroTracker/Trajectory.hpp"
+
+// Steps per degree of the axes, about those of the default mount at slew microstepping
+#define RA_STEPS_PER_DEGREE 1124.0
+#define DEC_STEPS_PER_DEGREE 1735.0
+// Time between the waypoints a client streams, and between the mount's spline updates
+#define WAYPOINT_INTERVAL 5000UL
+#define UPDATE_INTERVAL TRAJECTORY_UPDATE_INTERVAL
+
+static int failures = 0;
+
+static void check(bool ok, const char* what)
+{
+  printf("%s: %s\n", ok ? "ok  " : "FAIL", what);
+  if (!ok)
+  {
+    failures++;
+  }
+}
+
+// The pass of a satellite in a circular 420km orbit (like the ISS) seen from latitude 50 degrees, with the
+// closest approach 300km east of the site. The earth's rotation is left out, it barely changes a pass of a few
+// minutes. Gives the stepper positions at time t (ms from closest approach) and the altitude in degrees.
+static void satellite(double t, double& raSteps, double& decSteps, double& altitude)
+{
+  const double earthRadius = 6371.0;
+  const double orbitRadius = earthRadius + 420.0;
+  const double rate = sqrt(398600.4418 / (orbitRadius * orbitRadius * orbitRadius));  // Radians per second
+  const double latitude = 50.0 * M_PI / 180.0;
+  const double offset = 300.0 / earthRadius;
+
+  // x towards the meridian on the equator, y east, z the pole
+  double zenith[3] = { cos(latitude), 0, sin(latitude) };
+  double east[3] = { 0, 1, 0 };
+  double north[3] = { -sin(latitude), 0, cos(latitude) };
+  double angle = rate * t / 1000.0;
+  double d[3];
+  double up = 0;
+  double length = 0;
+  for (int i = 0; i < 3; i++)
+  {
+    double closest = cos(offset) * zenith[i] + sin(offset) * east[i];
+    d[i] = orbitRadius * (cos(angle) * closest + sin(angle) * north[i]) - earthRadius * zenith[i];
+    length += d[i] * d[i];
+  }
+  length = sqrt(length);
+  for (int i = 0; i < 3; i++)
+  {
+    d[i] /= length;
+    up += d[i] * zenith[i];
+  }
+
+  // Hour angle is positive towards the west
+  raSteps = atan2(-d[1], d[0]) * 180.0 / M_PI * RA_STEPS_PER_DEGREE;
+  decSteps = asin(d[2]) * 180.0 / M_PI * DEC_STEPS_PER_DEGREE;
+  altitude = asin(up) * 180.0 / M_PI;
+}
+
+// Time the satellite rises above 10 degrees, ms from closest approach
+static long riseTime()
+{
+  long t = 0;
+  double ra, dec, altitude = 90;
+  while (altitude > 10)
+  {
+    t -= 1000;
+    satellite(t, ra, dec, altitude);
+  }
+  return t;
+}
+
+static void followPass()
+{
+  // The firmware's clock is somewhere in its run when the pass starts
+  const unsigned long start = 3600000UL;
+  const long rise = riseTime();
+  const int waypoints = 2 * (-rise) / WAYPOINT_INTERVAL + 1;
+  printf("      Pass of %d seconds, %d waypoints, %d held at once\n", (int)(-2 * rise / 1000), waypoints, TRAJECTORY_POINTS);
+
+  Trajectory trajectory;
+  int added = 0;
+  double worstRA = 0, worstDEC = 0, worstAtWaypoint = 0;
+  bool rejected = false;
+  bool followed = true;
+  unsigned long time = start;
+  for (;;)
+  {
+    // The client keeps the ring full
+    while (added < waypoints && trajectory.count() < TRAJECTORY_POINTS)
+    {
+      double ra, dec, altitude;
+      satellite(rise + (long)(added * WAYPOINT_INTERVAL), ra, dec, altitude);
+      rejected |= !trajectory.add(start + added * WAYPOINT_INTERVAL, ra, dec);
+      added++;
+    }
+
+    float ra, dec;
+    if (!trajectory.position(time, ra, dec))
+    {
+      break;
+    }
+    double trueRA, trueDEC, altitude;
+    satellite(rise + (long)(time - start), trueRA, trueDEC, altitude);
+    worstRA = fmax(worstRA, fabs(ra - trueRA) / RA_STEPS_PER_DEGREE * 3600.0);
+    worstDEC = fmax(worstDEC, fabs(dec - trueDEC) / DEC_STEPS_PER_DEGREE * 3600.0);
+    if ((time - start) % WAYPOINT_INTERVAL == 0)
+    {
+      worstAtWaypoint = fmax(worstAtWaypoint, fmax(fabs(ra - trueRA), fabs(dec - trueDEC)));
+    }
+    time += UPDATE_INTERVAL;
+  }
+
+  printf("      Largest spline error: RA %.1f\", DEC %.1f\", at a waypoint %.3f steps\n", worstRA, worstDEC, worstAtWaypoint);
+  check(!rejected && added == waypoints, "every waypoint of the pass was taken");
+  check(time == start + (waypoints - 1) * WAYPOINT_INTERVAL, "the pass ends at the last waypoint");
+  check(worstAtWaypoint < 0.1, "the spline passes through the waypoints");
+  check(worstRA < 30 && worstDEC < 30, "the spline stays within 30\" of the pass");
+}
+
+static void ring()
+{
+  Trajectory trajectory;
+  float ra, dec;
+  check(!trajectory.position(0, ra, dec), "no position without waypoints");
+
+  // A path that bends, so the tangents matter
+  for (int i = 0; i < TRAJECTORY_POINTS; i++)
+  {
+    trajectory.add(1000UL * i, 100.0f * i * i, -50.0f * i);
+  }
+  check(trajectory.count() == TRAJECTORY_POINTS, "the ring holds TRAJECTORY_POINTS waypoints");
+  check(!trajectory.add(1000UL * TRAJECTORY_POINTS, 0, 0), "a full ring refuses a waypoint");
+  check(trajectory.position(0, ra, dec) && ra == 0 && dec == 0, "the first waypoint at its time");
+
+  // Passing waypoints drops all but the one the segment's start tangent needs
+  trajectory.position(5500, ra, dec);
+  check(trajectory.count() == TRAJECTORY_POINTS - 4, "passed waypoints are dropped");
+  check(!trajectory.add(1000UL * (TRAJECTORY_POINTS - 1), 0, 0), "a waypoint that is not after the last one is refused");
+
+  // Refill the ring until it wraps around twice and compare each segment with a fresh trajectory of the same points
+  bool same = true;
+  bool refilled = true;
+  int next = TRAJECTORY_POINTS;
+  for (unsigned long time = 5500; next < 3 * TRAJECTORY_POINTS; time += 700)
+  {
+    while (trajectory.count() < TRAJECTORY_POINTS)
+    {
+      refilled &= trajectory.add(1000UL * next, 100.0f * next * next, -50.0f * next);
+      next++;
+    }
+
+    int segment = time / 1000;
+    Trajectory fresh;
+    for (int i = (segment > 0 ? segment - 1 : 0); i < next; i++)
+    {
+      fresh.add(1000UL * i, 100.0f * i * i, -50.0f * i);
+    }
+    float freshRA, freshDEC;
+    same &= trajectory.position(time, ra, dec) && fresh.position(time, freshRA, freshDEC) && ra == freshRA && dec == freshDEC;
+  }
+  check(refilled, "dropped waypoints make room for new ones");
+  check(same, "the path is the same after the ring wraps around");
+
+  trajectory.clear();
+  check(trajectory.count() == 0 && !trajectory.position(1000000UL, ra, dec), "clear() empties the ring");
+}
+
+int main()
+{
+  followPass();
+  ring();
+  printf("%s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
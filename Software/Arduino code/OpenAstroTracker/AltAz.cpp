@@ -0,0 +1,53 @@
+#include <Arduino.h>
+#include "AltAz.hpp"
+#include "FastTrig.hpp"
+
+void AltAz::fromEquatorial(float ha, float dec, float latitude, float& altitude, float& azimuth)
+{
+  rotate(ha, dec, latitude, azimuth, altitude);
+  if (azimuth < 0)
+  {
+    azimuth += 360.0f;
+  }
+}
+
+void AltAz::toEquatorial(float altitude, float azimuth, float latitude, float& ha, float& dec)
+{
+  rotate(azimuth, altitude, latitude, ha, dec);
+}
+
+// The rotation is its own inverse: with the hour angle and azimuth both measured from the meridian, going from
+// (ha, dec) to (az, alt) is the same as going from (az, alt) to (ha, dec).
+void AltAz::rotate(float longitude, float latitude, float siteLatitude, float& outLongitude, float& outLatitude)
+{
+#if FAST_TRIG == 1
+  long sinSite = FastTrig::sin(FastTrig::fromDegrees(siteLatitude));
+  long cosSite = FastTrig::cos(FastTrig::fromDegrees(siteLatitude));
+  long sinLat = FastTrig::sin(FastTrig::fromDegrees(latitude));
+  long cosLat = FastTrig::cos(FastTrig::fromDegrees(latitude));
+  long sinLong = FastTrig::sin(FastTrig::fromDegrees(longitude));
+  long cosLong = FastTrig::cos(FastTrig::fromDegrees(longitude));
+
+  // The rotated vector, with 28 fractional bits
+  long x = cosSite * sinLat - ((sinSite * cosLat) >> 14) * cosLong;
+  long y = -sinLong * cosLat;
+  long z = sinSite * sinLat + ((cosSite * cosLat) >> 14) * cosLong;
+
+  // Its length in the horizontal plane, with 15 fractional bits so the squares fit in 32 bits
+  x >>= 13;
+  y >>= 13;
+  long length = FastTrig::isqrt((unsigned long)(x * x + y * y));
+
+  outLongitude = FastTrig::toDegrees(FastTrig::atan2(y, x));
+  outLatitude = FastTrig::toDegrees(FastTrig::atan2(z >> 13, length));
+#else
+  float sinSite = sin(siteLatitude * DEG_TO_RAD);
+  float cosSite = cos(siteLatitude * DEG_TO_RAD);
+  float sinLat = sin(latitude * DEG_TO_RAD);
+  float cosLat = cos(latitude * DEG_TO_RAD);
+  float cosLong = cos(longitude * DEG_TO_RAD);
+
+  outLatitude = asin(sinSite * sinLat + cosSite * cosLat * cosLong) * RAD_TO_DEG;
+  outLongitude = atan2(-sin(longitude * DEG_TO_RAD) * cosLat, cosSite * sinLat - sinSite * cosLat * cosLong) * RAD_TO_DEG;
+#endif
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Configuration_adv.hpp"
+
+//////////////////////////////////////////////////////////////////
+//
+// Conversion between equatorial (hour angle and declination) and horizontal (altitude and azimuth) positions.
+//
+// Both ways are the same rotation of the unit vector about the east-west axis by the colatitude of the site.
+// With FAST_TRIG it is done in fixed point with the FastTrig tables and is good to 0.015 degrees,
+// otherwise it uses the float math library.
+// Azimuth runs from north through east, hour angle is positive to the west.
+//////////////////////////////////////////////////////////////////
+class AltAz {
+public:
+  // Altitude (-90 to 90) and azimuth (0 to 360) in degrees of the given hour angle and declination (degrees).
+  static void fromEquatorial(float ha, float dec, float latitude, float& altitude, float& azimuth);
+
+  // Hour angle (-180 to 180) and declination (-90 to 90) in degrees of the given altitude and azimuth (degrees).
+  static void toEquatorial(float altitude, float azimuth, float latitude, float& ha, float& dec);
+
+private:
+  static void rotate(float longitude, float latitude, float siteLatitude, float& outLongitude, float& outLatitude);
+};
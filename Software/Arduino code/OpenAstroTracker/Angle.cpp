@@ -0,0 +1,62 @@
+#include "Angle.hpp"
+
+#define SECONDS_PER_TURN      86400L
+#define ARCSECONDS_PER_TURN   1296000L
+// 2^32 as a float
+#define TURN                  4294967296.0f
+
+Angle Angle::fromHours(float hours)
+{
+  return Angle((uint32_t)(int64_t)(hours * (TURN / 24.0f)));
+}
+
+Angle Angle::fromDegrees(float degrees)
+{
+  return Angle((uint32_t)(int64_t)(degrees * (TURN / 360.0f)));
+}
+
+Angle Angle::fromTime(const DayTime& time)
+{
+  int64_t seconds = 3600L * time.getHours() + 60L * time.getMinutes() + time.getSeconds();
+  return Angle((uint32_t)(seconds * 4294967296LL / SECONDS_PER_TURN));
+}
+
+Angle Angle::fromDegreeTime(const DegreeTime& degrees)
+{
+  int64_t arcseconds = 3600L * degrees.getHours() + 60L * degrees.getMinutes() + degrees.getSeconds();
+  return Angle((uint32_t)(arcseconds * 4294967296LL / ARCSECONDS_PER_TURN));
+}
+
+float Angle::hours() const
+{
+  return _value * (24.0f / TURN);
+}
+
+float Angle::signedHours() const
+{
+  return (int32_t)_value * (24.0f / TURN);
+}
+
+float Angle::signedDegrees() const
+{
+  return (int32_t)_value * (360.0f / TURN);
+}
+
+DayTime Angle::toDayTime() const
+{
+  long seconds = (long)(((uint64_t)_value * SECONDS_PER_TURN + 0x80000000UL) >> 32);
+  if (seconds == SECONDS_PER_TURN)
+  {
+    seconds = 0;
+  }
+  return DayTime(seconds / 3600, (seconds / 60) % 60, seconds % 60);
+}
+
+DegreeTime Angle::toDegreeTime() const
+{
+  long arcseconds = (long)(((int64_t)(int32_t)_value * ARCSECONDS_PER_TURN + 0x80000000L) >> 32);
+  // Degrees round down like DegreeTime(float), so minutes and seconds are never negative.
+  long degrees = (arcseconds >= 0) ? arcseconds / 3600 : -((3599 - arcseconds) / 3600);
+  long remainder = arcseconds - degrees * 3600;
+  return DegreeTime(degrees, remainder / 60, remainder % 60);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Arduino.h>
+#include "DayTime.hpp"
+
+//////////////////////////////////////////////////////////////////
+//
+// An angle as a fraction of a full turn, 2^32 units per turn (~0.3 milli-arcseconds, ~20us of time).
+//
+// Adding and subtracting wrap around the circle by unsigned overflow, so coordinates never need to be
+// normalized and the math is a single 32 bit add. Hours (RA, HA, LST) and degrees (DEC) are the same
+// type, 24h and 360 degrees are both one turn. DayTime and DegreeTime are only used to show and edit them.
+//////////////////////////////////////////////////////////////////
+class Angle {
+public:
+  Angle() : _value(0) {}
+
+  static Angle fromRaw(uint32_t value) { return Angle(value); }
+  static Angle fromHours(float hours);
+  static Angle fromDegrees(float degrees);
+
+  // From hours, minutes and seconds of time.
+  static Angle fromTime(const DayTime& time);
+
+  // From degrees, arcminutes and arcseconds, in the internal DEC range (0 at the pole, negative towards the equator).
+  static Angle fromDegreeTime(const DegreeTime& degrees);
+
+  uint32_t raw() const { return _value; }
+
+  // 0 to 24
+  float hours() const;
+  // -12 to 12
+  float signedHours() const;
+  // -180 to 180
+  float signedDegrees() const;
+
+  // Rounded to the nearest second of time, 0 to 24h.
+  DayTime toDayTime() const;
+  // Rounded to the nearest arcsecond, -180 to 180 degrees.
+  DegreeTime toDegreeTime() const;
+
+  Angle operator+(const Angle& other) const { return Angle(_value + other._value); }
+  Angle operator-(const Angle& other) const { return Angle(_value - other._value); }
+  Angle operator-() const { return Angle(0 - _value); }
+  Angle& operator+=(const Angle& other) { _value += other._value; return *this; }
+  Angle& operator-=(const Angle& other) { _value -= other._value; return *this; }
+  bool operator==(const Angle& other) const { return _value == other._value; }
+  bool operator!=(const Angle& other) const { return _value != other._value; }
+
+private:
+  explicit Angle(uint32_t value) : _value(value) {}
+
+  uint32_t _value;
+};
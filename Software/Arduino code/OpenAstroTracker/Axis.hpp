@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Configuration_adv.hpp"
+
+// How many degrees the RA ring turns in one hour to follow the sky (15 degrees per 23h56m04s).
+constexpr float siderealDegreesInHour = 14.95902778;
+
+//////////////////////////////////////////////////////////////////
+//
+// Compile-time description of one mount axis (stepper + driver + microstepping).
+//
+// The steps per degree are calibrated at runtime (and stored in EEPROM), but everything that
+// scales them only depends on the configured hardware. Axis collects those factors as constants
+// so that Mount's hot paths (guiding, tracking, slew target calculation) are a single multiply
+// by a folded constant instead of a nest of #if's.
+//
+// To add a new driver type, add an AxisDriver specialization below.
+//////////////////////////////////////////////////////////////////
+
+// Generic STEP/DIR drivers (A4988, DRV8825, TMC2209 standalone). Microstepping is set by the
+// MS pins, so the same mode is used for slewing and tracking.
+template <int Driver, int Microsteps, int TrackingMicrosteps>
+struct AxisDriver {
+  // Factor applied to the configured (full step) steps per degree.
+  static constexpr int slewMicrosteps = Microsteps;
+  // Motor steps per calibrated step on the slew stepper.
+  static constexpr float slewStepScale = 1.0f;
+  // Motor steps per calibrated step while tracking or guiding.
+  static constexpr float trackingStepScale = 1.0f;
+};
+
+// ULN2003 with a 28BYJ-48. Steps per degree are calibrated in half steps. Microsteps is the step
+// mode the slew stepper runs in (1 = FULLSTEP, 2 = HALFSTEP). The TRK stepper always runs HALFSTEP.
+template <int Microsteps, int TrackingMicrosteps>
+struct AxisDriver<ULN2003_DRIVER, Microsteps, TrackingMicrosteps> {
+  static constexpr int slewMicrosteps = 1;
+  static constexpr float slewStepScale = Microsteps / 2.0f;
+  static constexpr float trackingStepScale = 1.0f;
+};
+
+// TMC2209 over UART switches to a finer microstep mode while tracking.
+template <int Microsteps, int TrackingMicrosteps>
+struct AxisDriver<TMC2209_UART, Microsteps, TrackingMicrosteps> {
+  static constexpr int slewMicrosteps = Microsteps;
+  static constexpr float slewStepScale = 1.0f;
+  static constexpr float trackingStepScale = 1.0f * TrackingMicrosteps / Microsteps;
+};
+
+template <int Stepper, int Driver, int Microsteps, int TrackingMicrosteps = Microsteps>
+struct Axis : public AxisDriver<Driver, Microsteps, TrackingMicrosteps> {
+  typedef AxisDriver<Driver, Microsteps, TrackingMicrosteps> DriverType;
+
+  // The 28BYJ gear train has enough slack to need backlash correction, NEMA belt drives do not.
+  static constexpr int backlashSteps = (Stepper == STEP_28BYJ48) ? 16 : 0;
+
+  // Max speed of the TRK stepper when not guiding.
+  static constexpr float trackingMaxSpeed = (Stepper == STEP_28BYJ48) ? 10.0f : 500.0f;
+
+  // 28BYJ mounts guide at fixed rates (RA 2x/0x, DEC 1x sidereal), NEMA mounts use the *_PULSE_MULTIPLIER settings.
+  static constexpr bool fixedGuideRates = (Stepper == STEP_28BYJ48);
+
+  // NEMA steppers lag audibly when the TRK stepper runs during a slew.
+  static constexpr bool trackWhileSlewing = (Stepper == STEP_28BYJ48);
+
+  // TRK stepper steps per slew stepper step.
+  static constexpr float trackingStepsPerSlewStep = DriverType::trackingStepScale / DriverType::slewStepScale;
+
+  // Slew stepper steps needed to move one sidereal hour.
+  static constexpr float stepsPerSiderealHour(int stepsPerDegree) {
+    return stepsPerDegree * (DriverType::slewStepScale * siderealDegreesInHour);
+  }
+
+  // TRK stepper speed (steps/s) that follows the sky.
+  static constexpr float siderealStepsPerSecond(int stepsPerDegree) {
+    return stepsPerDegree * (DriverType::trackingStepScale * siderealDegreesInHour / 3600.0f);
+  }
+};
+
+// The axes of the configured mount. The 28BYJ RA stepper runs in FULLSTEP, DEC in HALFSTEP.
+typedef Axis<RA_STEPPER_TYPE, RA_DRIVER_TYPE, (RA_DRIVER_TYPE == ULN2003_DRIVER) ? 1 : SET_MICROSTEPPING, TRACKING_MICROSTEPPING> RAAxis;
+typedef Axis<DEC_STEPPER_TYPE, DEC_DRIVER_TYPE, (DEC_DRIVER_TYPE == ULN2003_DRIVER) ? 2 : DEC_SLEW_MICROSTEPPING, DEC_GUIDE_MICROSTEPPING> DECAxis;
@@ -15,6 +15,9 @@
 #define GENERIC_DRIVER     1
 #define TMC2209_STANDALONE 2
 #define TMC2209_UART       3
+// Coordinate epochs
+#define EPOCH_JNOW  0
+#define EPOCH_J2000 1
 //// DO NOT EDIT ABOVE HERE //////////////////////////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -64,8 +67,15 @@
 #define DEC_HOLDCURRENT 20    // [0, ... , 31] x/32 of the run current when standing still. 0=1/32... 31=32/32
 #define USE_AUTOHOME 0        // Autohome with TMC2209 stall detection:  ON = 1  |  OFF = 0   
 //                  ^^^ leave at 0 for now, doesnt work properly yet
+#define AUTOHOME_BACKOFF_STEPS 400       // After the first stall, back off this many steps and approach the stop again slowly
+#define AUTOHOME_SLOW_APPROACH_DIVISOR 4 // The second approach runs at 1/x of the first approach speed
 #define RA_AUDIO_FEEDBACK  0 // If one of these are set to 1, the respective driver will shut off the stealthchop mode, resulting in a audible whine
 #define DEC_AUDIO_FEEDBACK 0 // of the stepper coils. Use this to verify that UART is working properly. 
+#define SPREADCYCLE_SPEED 30  // Drivers run quiet StealthChop below this many times sidereal speed and switch to SpreadCycle (more torque)
+//                              above it, so slews don't stall. 0 = always StealthChop.
+#define COLLISION_DETECTION 0 // Stop a slew when a driver reports a stall on its DIAG pin (e.g. a snagged cable):  ON = 1  |  OFF = 0
+//                              Uses RA_STALL_VALUE/DEC_STALL_VALUE. StallGuard only works in StealthChop, so this keeps the
+//                              drivers in StealthChop for the whole slew and SPREADCYCLE_SPEED is ignored.
 
 
 ////////////////////////////
@@ -94,6 +104,121 @@
 #define NORTHERN_HEMISPHERE 1
 
 
+////////////////////////////
+//
+// POSITION CHECKPOINT
+// Set to 1 to save the mount position to EEPROM after each slew, when parked and periodically while tracking,
+// so the mount can resume after a power loss without re-aligning. There is no clock that runs without power,
+// so the mount cannot know how long it was off. After a resume RA is off by the length of the outage.
+#define POSITION_CHECKPOINT 1
+#define POSITION_CHECKPOINT_INTERVAL 300  // Seconds between checkpoints while tracking
+
+
+////////////////////////////
+//
+// POINTING MODEL
+// Set to 1 to correct gotos for polar misalignment, cone error and RA/DEC axis non-perpendicularity.
+// The first sync sets the position as before. Later syncs add an alignment point to the model instead,
+// so sync on a few stars spread over the sky. Each point takes 17 bytes of RAM.
+#define POINTING_MODEL 1
+#define POINTING_MODEL_POINTS 8  // Once this many points are stored, a sync replaces the oldest one
+
+
+////////////////////////////
+//
+// EPOCH CONVERSION
+// Set to 1 to accept and report J2000 coordinates. The mount moves in coordinates of date (JNow), so J2000
+// coordinates are corrected for precession and nutation, using the date set with :SC or from the GPS.
+// Clients read the epoch with :XGE# and can select it with :XSEn#.
+#define EPOCH_CONVERSION 1
+#define DEFAULT_EPOCH EPOCH_JNOW  // Epoch after a restart, EPOCH_JNOW | EPOCH_J2000
+#define EPOCH_UPDATE_HOURS 24     // Hours between recalculating the precession, which moves 0.14" a day
+
+
+////////////////////////////
+//
+// REFRACTION TRACKING
+// Set to 1 to be able to correct tracking for atmospheric refraction, which slows targets down near the
+// horizon and makes them drift in DEC. The RA and DEC rates are recalculated from the mount's position
+// every REFRACTION_UPDATE_INTERVAL seconds while tracking. Clients turn it on with :XSF1#.
+#define REFRACTION_TRACKING 1
+#define REFRACTION_UPDATE_INTERVAL 5  // Seconds
+
+////////////////////////////
+//
+// TRAJECTORY FOLLOWING
+// Set to 1 to be able to follow satellites and other fast movers. A client uploads time-tagged RA/DEC
+// waypoints (:XTA) and starts the pass (:XTS). The mount runs the RA and DEC steppers at the speed that keeps
+// them on a spline through the waypoints, updated every TRAJECTORY_UPDATE_INTERVAL milliseconds.
+// TRAJECTORY_POINTS waypoints are held at once; passed waypoints are dropped, so a long pass can be streamed.
+#define TRAJECTORY_FOLLOWING 1
+#define TRAJECTORY_POINTS 16
+#define TRAJECTORY_UPDATE_INTERVAL 100  // Milliseconds
+
+////////////////////////////
+//
+// MERIDIAN FLIP
+// While tracking, the RA ring turns west until it runs out of travel. Set to 1 to watch for that. Once the ring is
+// MERIDIAN_FLIP_LIMIT hours west of home the mount reports that a flip is needed (:GX, :XGW). With MERIDIAN_FLIP_AUTO
+// set to 1 it then slews to the same position on the other side of the pier by itself, which puts the ring 12 hours
+// further east. Both can be changed at runtime with :XSW. The ring is checked every MERIDIAN_FLIP_CHECK_INTERVAL seconds.
+#define MERIDIAN_FLIP 1
+#define MERIDIAN_FLIP_LIMIT 6.0         // Hours west of home, 6 to 12
+#define MERIDIAN_FLIP_AUTO 0
+#define MERIDIAN_FLIP_CHECK_INTERVAL 10  // Seconds
+
+////////////////////////////
+//
+// MOUNT LIMITS
+// Set to 1 to keep the mount from pointing into the ground or turning into its tripod. Gotos below the horizon
+// mask or outside the axis limits are rejected, and tracking stops when it reaches them (checked every
+// LIMIT_CHECK_INTERVAL seconds). A trajectory pass stops when it is about to reach them. The horizon mask and
+// the limits of the site are kept in EEPROM and set with the :XL commands; until then these defaults apply and
+// there is no horizon mask.
+#define MOUNT_LIMITS 1
+#define LIMIT_RA_EAST 6.0       // Hours the RA ring may turn east of home
+#define LIMIT_RA_WEST 6.0       // Hours the RA ring may turn west of home
+#define LIMIT_DEC 180           // Degrees the DEC axis may turn from home, in either direction
+#define LIMIT_CHECK_INTERVAL 10 // Seconds
+
+////////////////////////////
+//
+// PIER SIDE SELECTION
+// Set to 1 to let gotos choose the pier side when the target is within the axis limits from both sides. The side
+// the steppers get there sooner from is used, unless it leaves less than PIER_SIDE_MIN_TRACKING hours of tracking
+// before the mount has to flip. Otherwise the side follows from the 6 hour RA range. :XGI# reports the chosen side.
+// The sides are 12 hours apart, so there is only a choice when LIMIT_RA_EAST and LIMIT_RA_WEST (or the limits set
+// with :XLSE) add up to more than 12 hours. Without MOUNT_LIMITS the configured defaults apply.
+#define PIER_SIDE_SELECTION 1
+#define PIER_SIDE_MIN_TRACKING 1.0  // Hours
+
+////////////////////////////
+//
+// MANUAL SLEW RAMPS
+// Set to 1 to ramp manual slews up and down instead of changing speed at once. This covers the :Mn# moves, the
+// :XSX# and :XSY# speeds of manual slew mode and the LCD control buttons. Each slew rate preset (Guide, Center,
+// Find, Slew) has its own acceleration and deceleration, as fractions of the axis' maximum acceleration, so the
+// slow presets can start and stop gently for centering. The presets can be changed with :XSAn,a,d#.
+// With MANUAL_SLEW_HOLD_ACCELERATE the LCD control buttons start at the Guide rate and go up one preset every
+// MANUAL_SLEW_HOLD_TIME milliseconds the button is held.
+#define MANUAL_SLEW_RAMPS 1
+#define MANUAL_SLEW_ACCELERATION { 0.25, 0.5, 0.75, 1.0 }   // Guide, Center, Find, Slew
+#define MANUAL_SLEW_DECELERATION { 0.5, 0.75, 1.0, 1.0 }    // Guide, Center, Find, Slew
+#define MANUAL_SLEW_HOLD_ACCELERATE 1
+#define MANUAL_SLEW_HOLD_TIME 1500    // Milliseconds
+
+////////////////////////////
+//
+// FAST TRIG
+// Set to 1 to convert between RA/DEC and altitude/azimuth (:GA#, :GZ# and the horizon mask) and to apply the pointing
+// model with fixed point sine, cosine and arctangent tables in flash, instead of the float math library which takes
+// well over 100us a call on the AVR boards. The tables take 0.5kB of flash and the result is good to 0.015 degrees.
+// With FAST_TRIG_TIMING set to 1 an AVR board prints the cycles per call of the tables, the math library and the
+// altitude/azimuth conversion to the serial port at startup. The accuracy is checked by HostTests/fasttrig_test.
+#define FAST_TRIG 1
+#define FAST_TRIG_TIMING 0
+
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //                  ////////
 // LCD SETTINGS     ////////
@@ -139,6 +264,17 @@
 #define ALTITUDE_ARC_SECONDS_PER_STEP (0.61761f)
 #define ALTITUDE_STEPS_PER_ARC_MINUTE (60.0f/ALTITUDE_ARC_SECONDS_PER_STEP)
 
+// Steps a motor turns without moving the mount after it reverses. They are added to moves that reverse.
+#define AZIMUTH_BACKLASH_STEPS 0
+#define ALTITUDE_BACKLASH_STEPS 0
+
+// Set to 1 for closed loop polar alignment with the motors. The client measures how far the polar axis is off
+// (e.g. by plate solving near the pole) and sends it with :XAM. The mount corrects it and asks for the next
+// measurement, until the axis is within POLAR_ALIGN_TOLERANCE. See :XAS, :XAM and :XAG.
+#define POLAR_ALIGNMENT 1
+#define POLAR_ALIGN_TOLERANCE 0.5       // Arcminutes
+#define POLAR_ALIGN_MAX_ITERATIONS 8
+
 
 // Set this to 1 if you are using a NEO6m GPS module for HA/LST and location automatic determination.
 // GPS uses Serial1 by default, which is pins 18/19 on Mega. Change in configuration_adv.hpp
@@ -153,6 +289,22 @@
 // Set this to 1 if your gyro is mounted such that roll and pitch are in the wrong direction
 #define GYRO_AXIS_SWAP 1
 
+// The gyro is read in the background, one sample every GYRO_SAMPLE_INTERVAL milliseconds, and the angles are those of
+// the average of the last GYRO_SAMPLES samples. More samples give steadier angles that take longer to follow a change.
+#define GYRO_SAMPLE_INTERVAL 20         // Milliseconds
+#define GYRO_SAMPLES 16
+
+// Set this to 1 to level the mount with the altitude motor (needs GYRO_LEVEL and AZIMUTH_ALTITUDE_MOTORS). The motor
+// is moved until the pitch is within AUTO_LEVEL_TOLERANCE of the pitch offset set in the CAL menu. Start it with UP
+// in the CAL menu's Pitch Offset screen or with :XVS#. The pitch moved per arcminute of altitude is learnt from the
+// moves, and every move is limited to AUTO_LEVEL_MAX_MOVE in case it is learnt wrong. Leaving the CAL menu stops a
+// levelling started there, one started with :XVS# keeps running until it is done or stopped with :XVQ#.
+#define AUTO_LEVEL 1
+#define AUTO_LEVEL_TOLERANCE 0.1        // Degrees
+#define AUTO_LEVEL_MAX_MOVE 30          // Arcminutes of altitude per move
+#define AUTO_LEVEL_MAX_MOVES 20
+#define AUTO_LEVEL_SETTLE_TIME 500      // Milliseconds to wait after a move before reading the gyro
+
 
 
 #if HEADLESS_CLIENT == 0 // <-- Ignore this line
@@ -0,0 +1,107 @@
+#include "EPROMJournal.hpp"
+#include "EPROMStore.hpp"
+#include "Utility.hpp"
+
+// Each slot is the sequence number (2 bytes), the record and a CRC8 (1 byte)
+#define JOURNAL_OVERHEAD 3
+// Erased EEPROM reads as 0xFF, so this sequence number is never written
+#define JOURNAL_ERASED 0xFFFF
+// Starting the CRC at 0xFF keeps a slot of all zeroes from being valid
+#define JOURNAL_CRC_SEED 0xFF
+
+// CRC-8, polynomial 0x07, over the bytes of one slot
+static uint8_t crc8(uint8_t crc, uint8_t value)
+{
+  crc ^= value;
+  for (byte i = 0; i < 8; i++)
+  {
+    crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+  }
+  return crc;
+}
+
+EPROMJournal::EPROMJournal(int start, int end, byte recordSize)
+{
+  _start = start;
+  _recordSize = min(recordSize, (byte)JOURNAL_MAX_RECORD_SIZE);
+  _slots = (end - start) / (_recordSize + JOURNAL_OVERHEAD);
+  _newest = -1;
+  _sequence = 0;
+}
+
+// Scan all slots for the newest valid record
+void EPROMJournal::begin()
+{
+  uint8_t data[JOURNAL_MAX_RECORD_SIZE];
+  _newest = -1;
+  for (int slot = 0; slot < _slots; slot++)
+  {
+    uint16_t sequence;
+    // The sequence number wraps, so compare the difference. Slots are at most _slots appends apart.
+    if (readSlot(slot, data, sequence) && ((_newest < 0) || ((int16_t)(sequence - _sequence) > 0)))
+    {
+      _newest = slot;
+      _sequence = sequence;
+    }
+  }
+  LOGV5(DEBUG_VERBOSE, "Journal[%d]: %d slots, newest is %d (sequence %d)", _start, _slots, _newest, _sequence);
+}
+
+// Get the newest record
+bool EPROMJournal::read(void* data)
+{
+  uint16_t sequence;
+  return (_newest >= 0) && readSlot(_newest, (uint8_t*)data, sequence);
+}
+
+// Write the record to the slot after the newest one
+void EPROMJournal::append(const void* data)
+{
+  const uint8_t* bytes = (const uint8_t*)data;
+  int slot = (_newest + 1) % _slots;
+  uint16_t sequence = (_sequence + 1 == JOURNAL_ERASED) ? 0 : _sequence + 1;
+  int address = slotAddress(slot);
+
+  uint8_t crc = crc8(crc8(JOURNAL_CRC_SEED, sequence & 0x00FF), sequence >> 8);
+  EPROMStore::Storage()->update(address++, sequence & 0x00FF);
+  EPROMStore::Storage()->update(address++, sequence >> 8);
+  for (byte i = 0; i < _recordSize; i++)
+  {
+    crc = crc8(crc, bytes[i]);
+    EPROMStore::Storage()->update(address++, bytes[i]);
+  }
+  EPROMStore::Storage()->update(address, crc);
+  EPROMStore::Storage()->commit();
+
+  LOGV4(DEBUG_VERBOSE, "Journal[%d]: Wrote sequence %d to slot %d", _start, sequence, slot);
+  _newest = slot;
+  _sequence = sequence;
+}
+
+// Get the number of slots
+int EPROMJournal::slots() const
+{
+  return _slots;
+}
+
+// Get the EEPROM location of the given slot
+int EPROMJournal::slotAddress(int slot) const
+{
+  return _start + slot * (_recordSize + JOURNAL_OVERHEAD);
+}
+
+// Read one slot, returns false if it was never written or is damaged
+bool EPROMJournal::readSlot(int slot, uint8_t* data, uint16_t& sequence)
+{
+  int address = slotAddress(slot);
+  uint8_t lo = EPROMStore::Storage()->read(address++);
+  uint8_t hi = EPROMStore::Storage()->read(address++);
+  uint8_t crc = crc8(crc8(JOURNAL_CRC_SEED, lo), hi);
+  for (byte i = 0; i < _recordSize; i++)
+  {
+    data[i] = EPROMStore::Storage()->read(address++);
+    crc = crc8(crc, data[i]);
+  }
+  sequence = lo + (uint16_t)hi * 256;
+  return (sequence != JOURNAL_ERASED) && (crc == EPROMStore::Storage()->read(address));
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <Arduino.h>
+
+// Largest record a journal can hold
+#define JOURNAL_MAX_RECORD_SIZE 32
+
+// Log-structured storage for state that is saved often, on top of EPROMStore.
+//
+// An EEPROM cell wears out after ~100000 writes, which a value saved every few minutes reaches
+// in months. The journal spreads the writes over a range of locations instead: each record is
+// written to the slot after the newest one, wrapping around at the end of the range, so every
+// cell is written once per trip around the range.
+//
+// A slot holds a 16 bit sequence number, the record and a CRC8. begin() reads the range once and
+// picks the valid slot with the highest sequence number, so boot cost is bounded by the size of
+// the range. A write that is cut short fails its CRC and the record before it is used instead.
+//
+// On ESP boards the EEPROM is emulated in a flash sector that is rewritten as a whole on every
+// commit, so there the journal only protects against torn writes.
+class EPROMJournal {
+public:
+  // Journal of records of recordSize bytes in the EEPROM locations start up to (not including) end.
+  EPROMJournal(int start, int end, byte recordSize);
+
+  // Find the newest record. Call once before read() or append().
+  void begin();
+
+  // Copy the newest record to data. Returns false if nothing was written yet.
+  bool read(void* data);
+
+  // Write data as the newest record.
+  void append(const void* data);
+
+  // Number of records the range holds, each cell is written once for this many appends.
+  int slots() const;
+
+private:
+  int slotAddress(int slot) const;
+  bool readSlot(int slot, uint8_t* data, uint16_t& sequence);
+
+  int _start;
+  byte _recordSize;
+  int _slots;
+  int _newest;
+  uint16_t _sequence;
+};
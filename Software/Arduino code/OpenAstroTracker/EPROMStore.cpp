@@ -1,7 +1,50 @@
+#include <stddef.h>
 #include <EEPROM.h>
 #include "EPROMStore.hpp"
 #include "Utility.hpp"
 
+// The config is stored twice, in two slots after the legacy locations.
+#define CONFIG_SLOT_ADDR      64
+#define CONFIG_SLOT_SIZE      128
+// How long the config must be unchanged before it is written (ms)
+#define CONFIG_COMMIT_DELAY   2000
+
+static_assert(sizeof(ConfigData) <= CONFIG_SLOT_SIZE, "ConfigData does not fit in its EEPROM slot");
+static_assert(CONFIG_SLOT_ADDR + 2 * CONFIG_SLOT_SIZE <= CONFIG_STORAGE_END, "Config slots overlap the free EEPROM");
+
+// Version 1 of the config, with a single set of mount values, in two 32 byte slots at 64.
+#define CONFIG_V1_SLOT_SIZE   32
+
+struct ConfigDataV1 {
+  uint8_t version;
+  uint8_t sequence;
+  uint8_t flags;
+  uint8_t brightness;
+  int16_t speedAdjust;
+  int16_t raStepsPerDegree;
+  int16_t decStepsPerDegree;
+  int16_t backlashSteps;
+  int16_t latitude;
+  int16_t longitude;
+  uint16_t pitchOffset;
+  uint16_t rollOffset;
+  uint8_t haHours;
+  uint8_t haMinutes;
+  uint16_t crc;
+};
+
+// Version 2 of the config, without the site limits, in the same slots as the current version.
+struct ConfigDataV2 {
+  uint8_t version;
+  uint8_t sequence;
+  uint8_t activeProfile;
+  uint8_t brightness;
+  uint8_t haHours;
+  uint8_t haMinutes;
+  MountProfile profiles[CONFIG_PROFILES];
+  uint16_t crc;
+};
+
 // The global instance of the platform-independant EEPROM class
 EPROMStore *EPROMStore::_eepromStore = NULL;
 
@@ -19,27 +62,47 @@ void EPROMStore::initialize()
 // Get the instance of the EEPROM storage
 EPROMStore *EPROMStore::Storage()
 {
+  // The LCD and the mount read their settings while being constructed, before setup() runs.
+  if (_eepromStore == NULL)
+  {
+    initialize();
+  }
   return _eepromStore;
 }
 
 #ifdef ESPBOARD
 
-// Construct the EEPROM object for ESP boards, settign aside 32 bytes for storage
+// Bytes of flash set aside for EEPROM emulation on ESP boards
+#define EEPROM_ESP_SIZE 1024
+
+// Construct the EEPROM object for ESP boards, settign aside EEPROM_ESP_SIZE bytes for storage
 EPROMStore::EPROMStore()
 {
-  LOGV1(DEBUG_VERBOSE, "EEPROM[ESP]: Startup with 32 bytes");
-  EEPROM.begin(32);
+  LOGV2(DEBUG_VERBOSE, "EEPROM[ESP]: Startup with %d bytes", EEPROM_ESP_SIZE);
+  EEPROM.begin(EEPROM_ESP_SIZE);
+  loadConfig();
 }
 
-// Update the given location with the given value
+// Update the given location with the given value. Call commit() to persist it.
 void EPROMStore::update(int location, uint8_t value)
 {
   LOGV3(DEBUG_VERBOSE, "EEPROM[ESP]: Writing %x to %d", value, location);
   EEPROM.write(location, value);
+}
+
+// Every commit rewrites the whole flash sector, so batch the updates before calling this.
+void EPROMStore::commit()
+{
   LOGV1(DEBUG_VERBOSE, "EEPROM[ESP]: Committing");
   EEPROM.commit();
 }
 
+// Get the size of the emulated EEPROM
+int EPROMStore::length()
+{
+  return EEPROM_ESP_SIZE;
+}
+
 // Read the value at the given location
 uint8_t EPROMStore::read(int location)
 {
@@ -55,13 +118,26 @@ uint8_t EPROMStore::read(int location)
 EPROMStore::EPROMStore()
 {
   LOGV1(DEBUG_VERBOSE, "EEPROM[UNO]: Startup ");
+  loadConfig();
 }
 
 // Update the given location with the given value
 void EPROMStore::update(int location, uint8_t value)
 {
   LOGV3(DEBUG_VERBOSE, "EEPROM[UNO]: Writing8 %x to %d", value, location);
-  EEPROM.write(location, value);
+  // Only erases and writes the cell if the value changed, the position checkpoint rewrites mostly the same bytes.
+  EEPROM.update(location, value);
+}
+
+// Writes go to the EEPROM right away, nothing to do.
+void EPROMStore::commit()
+{
+}
+
+// Get the size of the EEPROM (1KB on the Uno, 4KB on the Mega)
+int EPROMStore::length()
+{
+  return EEPROM.length();
 }
 
 // Read the value at the given location
@@ -83,10 +159,327 @@ void EPROMStore::updateInt16(int loByteAddr, int hiByteAddr, int16_t value)
 
 int16_t EPROMStore::readInt16(int loByteAddr, int hiByteAddr)
 {
-  uint8_t valLo=EPROMStore::Storage()->read(loByteAddr);
-  uint8_t valHi=EPROMStore::Storage()->read(hiByteAddr);
+  uint8_t valLo=read(loByteAddr);
+  uint8_t valHi=read(hiByteAddr);
   uint16_t uValue = (uint16_t)valLo + (uint16_t)valHi * 256;
   int16_t value = static_cast<int16_t>(uValue);
   LOGV4(DEBUG_VERBOSE, "EEPROM: Read16 %d from %d, %d", value, loByteAddr, hiByteAddr);
   return value;
 }
+
+void EPROMStore::updateInt32(int address, int32_t value)
+{
+  LOGV3(DEBUG_VERBOSE, "EEPROM: Writing32 %l to %d", value, address);
+  for (int i = 0; i < 4; i++) {
+    update(address + i, (value >> (8 * i)) & 0x00FF);
+  }
+}
+
+int32_t EPROMStore::readInt32(int address)
+{
+  uint32_t uValue = 0;
+  for (int i = 0; i < 4; i++) {
+    uValue |= (uint32_t)read(address + i) << (8 * i);
+  }
+  int32_t value = static_cast<int32_t>(uValue);
+  LOGV3(DEBUG_VERBOSE, "EEPROM: Read32 %l from %d", value, address);
+  return value;
+}
+
+static uint16_t crc16(const uint8_t* data, size_t length)
+{
+  // CRC-16/CCITT-FALSE
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (byte j = 0; j < 8; j++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+    }
+  }
+  return crc;
+}
+
+// Get the stored configuration
+ConfigData& EPROMStore::config()
+{
+  return _config;
+}
+
+// Get the profile the mount uses
+MountProfile& EPROMStore::profile()
+{
+  return _config.profiles[_config.activeProfile];
+}
+
+// Switch to another profile
+bool EPROMStore::selectProfile(byte index)
+{
+  if (index >= CONFIG_PROFILES)
+  {
+    return false;
+  }
+
+  if (_config.profiles[index].name[0] == 0)
+  {
+    // Start from the current calibration, usually only a few values differ between mounts.
+    _config.profiles[index] = profile();
+    sprintf(_config.profiles[index].name, "Mount %d", index + 1);
+    LOGV3(DEBUG_INFO, "EEPROM: Profile %d starts as a copy of profile %d", index, _config.activeProfile);
+  }
+
+  _config.activeProfile = index;
+  configChanged();
+  return true;
+}
+
+// Remember that the configuration needs to be written
+void EPROMStore::configChanged()
+{
+  _configDirty = true;
+  _configChangedAt = millis();
+}
+
+// Write the configuration once it has settled
+void EPROMStore::process()
+{
+  if (_configDirty && (millis() - _configChangedAt > CONFIG_COMMIT_DELAY))
+  {
+    flushConfig();
+  }
+}
+
+// Write the configuration if it has changed
+void EPROMStore::flushConfig()
+{
+  if (_configDirty)
+  {
+    // Never overwrite the copy that was read or written last.
+    writeConfigSlot(_configSlot ^ 1);
+    _configDirty = false;
+  }
+}
+
+// Read the configuration from the newest valid slot, or from the legacy locations
+void EPROMStore::loadConfig()
+{
+  ConfigData slots[2];
+  bool valid[2];
+  for (byte slot = 0; slot < 2; slot++)
+  {
+    valid[slot] = readConfigSlot(slot, slots[slot]);
+  }
+
+  _configDirty = false;
+  _configChangedAt = 0;
+  if (valid[0] || valid[1])
+  {
+    // The sequence number wraps, so compare the difference.
+    _configSlot = (valid[0] && (!valid[1] || (int8_t)(slots[0].sequence - slots[1].sequence) > 0)) ? 0 : 1;
+    _config = slots[_configSlot];
+    LOGV4(DEBUG_INFO, "EEPROM: Config version %d, sequence %d, from slot %d", _config.version, _config.sequence, _configSlot);
+
+    if (_config.version != CONFIG_VERSION)
+    {
+      // Written by another firmware version. Keep it until something is changed, the legacy locations are older still.
+      LOGV2(DEBUG_INFO, "EEPROM: Unknown config version %d, using the defaults until the config is changed", _config.version);
+      byte sequence = _config.sequence;
+      defaultConfig();
+      _config.sequence = sequence;
+    }
+  }
+  else if (!migrateConfigV2())
+  {
+    // Slot 1 does not overlap the version 1 slots, so write it first. A power loss can then not lose both.
+    _configSlot = 0;
+    if (!migrateConfigV1())
+    {
+      migrateLegacyConfig();
+    }
+  }
+
+  if (_config.activeProfile >= CONFIG_PROFILES)
+  {
+    _config.activeProfile = 0;
+  }
+}
+
+// Build the configuration from the newest version 2 slot. Returns false if neither is valid.
+bool EPROMStore::migrateConfigV2()
+{
+  ConfigDataV2 newest;
+  byte newestSlot = 0;
+  bool found = false;
+  for (byte slot = 0; slot < 2; slot++)
+  {
+    ConfigDataV2 data;
+    uint8_t* bytes = (uint8_t*)&data;
+    int address = CONFIG_SLOT_ADDR + slot * CONFIG_SLOT_SIZE;
+    for (size_t i = 0; i < sizeof(ConfigDataV2); i++)
+    {
+      bytes[i] = read(address + i);
+    }
+
+    if ((data.version == 2) && (data.crc == crc16(bytes, offsetof(ConfigDataV2, crc))) &&
+        (!found || (int8_t)(data.sequence - newest.sequence) > 0))
+    {
+      newest = data;
+      newestSlot = slot;
+      found = true;
+    }
+  }
+
+  if (!found)
+  {
+    return false;
+  }
+
+  LOGV3(DEBUG_INFO, "EEPROM: Migrating version 2 config, sequence %d, from slot %d", newest.sequence, newestSlot);
+  memset(&_config, 0, sizeof(_config));
+  _config.version = CONFIG_VERSION;
+  _config.sequence = newest.sequence;
+  _config.activeProfile = newest.activeProfile;
+  _config.brightness = newest.brightness;
+  _config.haHours = newest.haHours;
+  _config.haMinutes = newest.haMinutes;
+  memcpy(_config.profiles, newest.profiles, sizeof(_config.profiles));
+  clearSiteLimits();
+
+  // The migrated config goes to the other slot, so the newest version 2 copy survives a power loss.
+  _configSlot = newestSlot;
+  configChanged();
+  return true;
+}
+
+// No horizon mask and the default axis limits
+void EPROMStore::clearSiteLimits()
+{
+  memset(&_config.site, 0, sizeof(_config.site));
+  for (byte sector = 0; sector < HORIZON_SECTORS; sector++)
+  {
+    _config.site.horizon[sector] = HORIZON_NONE;
+  }
+}
+
+// Build the configuration from the newest version 1 slot. Returns false if neither is valid.
+bool EPROMStore::migrateConfigV1()
+{
+  ConfigDataV1 newest;
+  bool found = false;
+  for (byte slot = 0; slot < 2; slot++)
+  {
+    ConfigDataV1 data;
+    uint8_t* bytes = (uint8_t*)&data;
+    int address = CONFIG_SLOT_ADDR + slot * CONFIG_V1_SLOT_SIZE;
+    for (size_t i = 0; i < sizeof(ConfigDataV1); i++)
+    {
+      bytes[i] = read(address + i);
+    }
+
+    if ((data.version == 1) && (data.crc == crc16(bytes, offsetof(ConfigDataV1, crc))) &&
+        (!found || (int8_t)(data.sequence - newest.sequence) > 0))
+    {
+      newest = data;
+      found = true;
+    }
+  }
+
+  if (!found)
+  {
+    return false;
+  }
+
+  LOGV2(DEBUG_INFO, "EEPROM: Migrating version 1 config, sequence %d", newest.sequence);
+  memset(&_config, 0, sizeof(_config));
+  _config.version = CONFIG_VERSION;
+  _config.sequence = newest.sequence;
+  _config.brightness = newest.brightness;
+  _config.haHours = newest.haHours;
+  _config.haMinutes = newest.haMinutes;
+
+  MountProfile& profile = _config.profiles[0];
+  strcpy(profile.name, "Default");
+  profile.flags = newest.flags;
+  profile.speedAdjust = newest.speedAdjust;
+  profile.raStepsPerDegree = newest.raStepsPerDegree;
+  profile.decStepsPerDegree = newest.decStepsPerDegree;
+  profile.backlashSteps = newest.backlashSteps;
+  profile.latitude = newest.latitude;
+  profile.longitude = newest.longitude;
+  profile.pitchOffset = newest.pitchOffset;
+  profile.rollOffset = newest.rollOffset;
+  clearSiteLimits();
+
+  configChanged();
+  return true;
+}
+
+// The configuration of a mount that was never set up, in RAM only
+void EPROMStore::defaultConfig()
+{
+  memset(&_config, 0, sizeof(_config));
+  _config.version = CONFIG_VERSION;
+  strcpy(_config.profiles[0].name, "Default");
+  clearSiteLimits();
+}
+
+// Build the configuration from the single byte locations used before the config was versioned
+void EPROMStore::migrateLegacyConfig()
+{
+  // Location 5 is 0xBE once anything was written, location 4 has a bit for each value that was written.
+  bool hasMarker = read(5) == 0xBE;
+  LOGV2(DEBUG_INFO, "EEPROM: Migrating legacy config, marker %s", hasMarker ? "found" : "not found");
+
+  memset(&_config, 0, sizeof(_config));
+  _config.version = CONFIG_VERSION;
+
+  MountProfile& profile = _config.profiles[0];
+  strcpy(profile.name, "Default");
+  profile.flags = hasMarker ? read(4) : 0;
+  profile.speedAdjust = readInt16(0, 3);
+  profile.raStepsPerDegree = readInt16(6, 7);
+  profile.decStepsPerDegree = readInt16(8, 9);
+  profile.backlashSteps = readInt16(10, 11);
+  profile.latitude = readInt16(12, 13);
+  profile.longitude = readInt16(14, 15);
+  profile.pitchOffset = readInt16(17, 18);
+  profile.rollOffset = readInt16(19, 20);
+
+  // These were always read, whether written or not.
+  _config.brightness = read(16);
+  _config.haHours = read(1);
+  _config.haMinutes = read(2);
+  clearSiteLimits();
+
+  configChanged();
+}
+
+// Read one slot, returns false if it was never written or is damaged
+bool EPROMStore::readConfigSlot(byte slot, ConfigData& data)
+{
+  uint8_t* bytes = (uint8_t*)&data;
+  int address = CONFIG_SLOT_ADDR + slot * CONFIG_SLOT_SIZE;
+  for (size_t i = 0; i < sizeof(ConfigData); i++)
+  {
+    bytes[i] = read(address + i);
+  }
+
+  return data.crc == crc16(bytes, offsetof(ConfigData, crc));
+}
+
+// Write the configuration to the given slot, in a single commit
+void EPROMStore::writeConfigSlot(byte slot)
+{
+  _config.version = CONFIG_VERSION;
+  _config.sequence++;
+  _config.crc = crc16((const uint8_t*)&_config, offsetof(ConfigData, crc));
+  LOGV3(DEBUG_INFO, "EEPROM: Writing config sequence %d to slot %d", _config.sequence, slot);
+
+  const uint8_t* bytes = (const uint8_t*)&_config;
+  int address = CONFIG_SLOT_ADDR + slot * CONFIG_SLOT_SIZE;
+  for (size_t i = 0; i < sizeof(ConfigData); i++)
+  {
+    update(address + i, bytes[i]);
+  }
+  commit();
+  _configSlot = slot;
+}
@@ -1,10 +1,76 @@
 #pragma once
 #include <Arduino.h>
 
+// Version of the ConfigData layout. Bump it when the layout changes and migrate the older version in EPROMStore::loadConfig().
+#define CONFIG_VERSION 3
+
+// Number of mount profiles the configuration holds
+#define CONFIG_PROFILES 4
+// Longest profile name, without the terminating zero
+#define PROFILE_NAME_LENGTH 7
+
+// EEPROM locations after the configuration are free for other uses (see Mount's position checkpoint).
+#define CONFIG_STORAGE_END 320
+
+// The horizon mask has a sector for every 360 / HORIZON_SECTORS degrees of azimuth, the first one starting at north.
+#define HORIZON_SECTORS 12
+// Horizon mask value of a sector without a mask
+#define HORIZON_NONE -128
+
+// Bits in ConfigData::flags, set when the mount value has been stored. Same bits as the legacy flag byte (location 4).
+#define CONFIG_RA_STEPS       0x01
+#define CONFIG_DEC_STEPS      0x02
+#define CONFIG_SPEED          0x04
+#define CONFIG_BACKLASH       0x08
+#define CONFIG_LATITUDE       0x10
+#define CONFIG_LONGITUDE      0x20
+#define CONFIG_PITCH_OFFSET   0x40
+#define CONFIG_ROLL_OFFSET    0x80
+
+// The calibration of one mount. A profile is in use once it has a name.
+struct MountProfile {
+  int16_t speedAdjust;        // Tracking speed factor is 1 + speedAdjust / 10000
+  int16_t raStepsPerDegree;
+  int16_t decStepsPerDegree;
+  int16_t backlashSteps;
+  int16_t latitude;           // Degrees x 100
+  int16_t longitude;          // Degrees x 100
+  uint16_t pitchOffset;       // Degrees x 100 + 16384
+  uint16_t rollOffset;        // Degrees x 100 + 16384
+  char name[PROFILE_NAME_LENGTH + 1];
+  uint8_t flags;              // CONFIG_* bits of the values above that have been stored
+};
+
+// The limits of the site the mount is set up at, that keep it from pointing into the ground or turning into its
+// tripod. An axis limit of 0 uses the default from Configuration_adv.hpp.
+struct SiteLimits {
+  int8_t horizon[HORIZON_SECTORS];  // Lowest altitude in degrees per sector, HORIZON_NONE if there is no mask
+  uint8_t raLimitEast;        // Hours x 10 the RA ring may turn east of home
+  uint8_t raLimitWest;        // Hours x 10 the RA ring may turn west of home
+  uint8_t decLimitPlus;       // Degrees the DEC axis may turn from home, towards positive steps
+  uint8_t decLimitMinus;      // Degrees the DEC axis may turn from home, towards negative steps
+};
+
+// The configuration that is changed at runtime and kept in EEPROM.
+struct ConfigData {
+  uint8_t version;
+  uint8_t sequence;           // Incremented on every write, the newer of the two stored copies is used
+  uint8_t activeProfile;      // Index of the profile the mount uses
+  uint8_t brightness;         // LCD backlight
+  uint8_t haHours;            // Last HA that was set
+  uint8_t haMinutes;
+  MountProfile profiles[CONFIG_PROFILES];
+  SiteLimits site;
+  uint16_t crc;               // CRC16 of all the fields above
+};
+
 // Platform independant abstraction of the EEPROM storage capability of the boards.
 // This is needed because the ESP boards require two things that the Arduino boards don't:
 //  1) It wants to know how many bytes you want to use (at most)
 //  2) It wants you to call a commit() function after a write() to actual persist the data.
+//
+// The configuration is kept in RAM as a ConfigData and written as a whole, with a CRC. It is written
+// alternately to two slots, so a write that is cut short by a power loss leaves the previous copy intact.
 class EPROMStore {
   static EPROMStore *_eepromStore;
 public:
@@ -17,6 +83,48 @@ public:
   void updateInt16(int loByteAddr, int hiByteAddr, int16_t value);
   int16_t readInt16(int loByteAddr, int hiByteAddr);
 
+  // 32 bit values are stored in 4 consecutive locations, low byte first.
+  void updateInt32(int address, int32_t value);
+  int32_t readInt32(int address);
+
+  // Make the preceding update()s permanent. ESP boards only keep them in RAM until then.
+  void commit();
+
+  // Number of EEPROM locations that can be used.
+  int length();
+
+  // The stored configuration. Call configChanged() after changing it.
+  ConfigData& config();
+
+  // The profile the mount uses, part of config().
+  MountProfile& profile();
+
+  // Make the given profile the active one. A profile that is not in use yet starts as a copy of the active one.
+  bool selectProfile(byte index);
+
+  // Schedule the configuration to be written. Changes made close together are written at once by process().
+  void configChanged();
+
+  // Write the configuration once it has not changed for a moment. Call from the main loop when nothing is moving.
+  void process();
+
+  // Write the configuration right away if it has changed.
+  void flushConfig();
+
   static EPROMStore* Storage();
-};
 
+private:
+  void loadConfig();
+  bool migrateConfigV1();
+  bool migrateConfigV2();
+  void clearSiteLimits();
+  void defaultConfig();
+  void migrateLegacyConfig();
+  bool readConfigSlot(byte slot, ConfigData& data);
+  void writeConfigSlot(byte slot);
+
+  ConfigData _config;
+  byte _configSlot;
+  bool _configDirty;
+  unsigned long _configChangedAt;
+};
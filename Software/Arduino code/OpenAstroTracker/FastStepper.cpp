@@ -0,0 +1,128 @@
+#include "FastStepper.hpp"
+#include "Utility.hpp"
+
+#ifdef __AVR__
+
+// Coil patterns, bit 0 is pin1. Same sequences as AccelStepper::step4() and step8().
+const uint8_t fullStepPhases[4] PROGMEM = { 0b0101, 0b0110, 0b1010, 0b1001 };
+const uint8_t halfStepPhases[8] PROGMEM = { 0b0001, 0b0101, 0b0100, 0b0110, 0b0010, 0b1010, 0b1000, 0b1001 };
+
+FastStepper::FastStepper(byte interface, byte pin1, byte pin2, byte pin3, byte pin4)
+  : AccelStepper(interface, pin1, pin2, pin3, pin4)
+{
+  byte pins[4] = { pin1, pin2, pin3, pin4 };
+  _interface = interface;
+  _numPins = (interface == AccelStepper::DRIVER) ? 2 : 4;
+  _invertMask = 0;
+  _portMask = 0;
+  _pulseWidth = 1;
+
+  bool samePort = true;
+  for (byte i = 0; i < 4; i++) {
+    if (i < _numPins) {
+      _port[i] = portOutputRegister(digitalPinToPort(pins[i]));
+      _bit[i] = digitalPinToBitMask(pins[i]);
+      samePort = samePort && (_port[i] == _port[0]);
+      _portMask |= _bit[i];
+    }
+    else {
+      _port[i] = _port[0];
+      _bit[i] = 0;
+    }
+  }
+
+  if (!samePort) {
+    _portMask = 0;
+  }
+
+  LOGV4(DEBUG_MOUNT, "FastStepper: %d pins, starting at pin %d, %s", _numPins, pin1, samePort ? "single port" : "multiple ports");
+}
+
+void FastStepper::setDirectionInverted(bool inverted)
+{
+  if (_interface == AccelStepper::DRIVER) {
+    _invertMask = inverted ? 0b10 : 0b00;
+  }
+}
+
+void FastStepper::setMinPulseWidth(unsigned int minWidth)
+{
+  AccelStepper::setMinPulseWidth(minWidth);
+  _pulseWidth = minWidth;
+}
+
+// Bit n of mask is the level of pin n+1 (before inversion).
+void FastStepper::writePins(uint8_t mask)
+{
+  mask ^= _invertMask;
+  uint8_t oldSREG = SREG;
+  cli();
+  if (_portMask != 0) {
+    uint8_t bits = 0;
+    if (mask & 0b0001) bits |= _bit[0];
+    if (mask & 0b0010) bits |= _bit[1];
+    if (mask & 0b0100) bits |= _bit[2];
+    if (mask & 0b1000) bits |= _bit[3];
+    *_port[0] = (*_port[0] & ~_portMask) | bits;
+  }
+  else {
+    for (byte i = 0; i < _numPins; i++) {
+      if (mask & (1 << i)) {
+        *_port[i] |= _bit[i];
+      }
+      else {
+        *_port[i] &= ~_bit[i];
+      }
+    }
+  }
+  SREG = oldSREG;
+}
+
+void FastStepper::setOutputPins(uint8_t mask)
+{
+  writePins(mask);
+}
+
+void FastStepper::step(long step)
+{
+  switch (_interface) {
+    case AccelStepper::DRIVER:
+    // Set direction first, then pulse STEP for the driver's minimum pulse width.
+    writePins(_direction ? 0b10 : 0b00);
+    writePins(_direction ? 0b11 : 0b01);
+    delayMicroseconds(_pulseWidth);
+    writePins(_direction ? 0b10 : 0b00);
+    break;
+
+    case AccelStepper::FULL4WIRE:
+    writePins(pgm_read_byte(&fullStepPhases[step & 0x03]));
+    break;
+
+    case AccelStepper::HALF4WIRE:
+    writePins(pgm_read_byte(&halfStepPhases[step & 0x07]));
+    break;
+
+    default:
+    AccelStepper::step(step);
+    break;
+  }
+}
+
+#else
+
+FastStepper::FastStepper(byte interface, byte pin1, byte pin2, byte pin3, byte pin4)
+  : AccelStepper(interface, pin1, pin2, pin3, pin4)
+{
+}
+
+void FastStepper::setDirectionInverted(bool inverted)
+{
+  setPinsInverted(inverted, false, false);
+}
+
+void FastStepper::setMinPulseWidth(unsigned int minWidth)
+{
+  AccelStepper::setMinPulseWidth(minWidth);
+}
+
+#endif
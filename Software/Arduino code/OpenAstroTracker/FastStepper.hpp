@@ -0,0 +1,52 @@
+#pragma once
+
+#include <AccelStepper.h>
+#include "Configuration_adv.hpp"
+
+//////////////////////////////////////////////////////////////////
+//
+// AccelStepper that drives its pins directly through the AVR PORT registers.
+//
+// AccelStepper uses digitalWrite() for every pin on every step. On a 16MHz AVR each
+// digitalWrite() costs roughly 55-65 cycles (two PROGMEM table lookups, a PWM timer check
+// and an SREG save/restore), so one step costs:
+//
+//                       AccelStepper          FastStepper
+//   HALFSTEP/FULLSTEP   ~270 cycles (~17us)   ~35 cycles (~2.2us)   4 pins, same port
+//   DRIVER (step/dir)   ~200 cycles (~12us)   ~30 cycles (~1.9us)   plus the step pulse (1us default)
+//
+// The RA and TRK steppers share the RA pins, so a tracking 28BYJ mount saves ~15us for each step
+// the timer ISR takes. The pin to PORT mapping is looked up once at construction, the coil phase
+// patterns come from a PROGMEM table. When all pins live on the same PORT (the Mega pin
+// assignments all do) a step is a single read-modify-write of that PORT with interrupts off.
+//
+// On non-AVR boards this is a plain AccelStepper.
+//////////////////////////////////////////////////////////////////
+class FastStepper : public AccelStepper {
+public:
+  FastStepper(byte interface, byte pin1, byte pin2, byte pin3 = 0xFF, byte pin4 = 0xFF);
+
+  // Invert the direction pin (DRIVER mode only). Use this instead of setPinsInverted().
+  void setDirectionInverted(bool inverted);
+
+  // Width of the STEP pulse in microseconds (DRIVER mode), 1 by default. AccelStepper::setMinPulseWidth() is not
+  // virtual, so call this one on the FastStepper, not through an AccelStepper pointer.
+  void setMinPulseWidth(unsigned int minWidth);
+
+#ifdef __AVR__
+protected:
+  virtual void setOutputPins(uint8_t mask) override;
+  virtual void step(long step) override;
+
+private:
+  void writePins(uint8_t mask);
+
+  byte _interface;
+  byte _numPins;
+  volatile uint8_t* _port[4];
+  uint8_t _bit[4];
+  uint8_t _portMask;    // All pin bits if every pin is on _port[0], otherwise 0
+  uint8_t _invertMask;
+  unsigned int _pulseWidth;
+#endif
+};
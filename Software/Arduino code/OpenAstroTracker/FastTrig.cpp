@@ -0,0 +1,186 @@
+#include "Configuration_adv.hpp"
+
+#if FAST_TRIG == 1
+#include "FastTrig.hpp"
+
+// sin() of the first quadrant in 128 steps, 32768 is 1.0
+static const uint16_t sineTable[129] PROGMEM = {
+  0, 402, 804, 1206, 1608, 2009, 2411, 2811, 3212, 3612, 4011, 4410,
+  4808, 5205, 5602, 5998, 6393, 6787, 7180, 7571, 7962, 8351, 8740, 9127,
+  9512, 9896, 10279, 10660, 11039, 11417, 11793, 12167, 12540, 12910, 13279, 13646,
+  14010, 14373, 14733, 15091, 15447, 15800, 16151, 16500, 16846, 17190, 17531, 17869,
+  18205, 18538, 18868, 19195, 19520, 19841, 20160, 20475, 20788, 21097, 21403, 21706,
+  22006, 22302, 22595, 22884, 23170, 23453, 23732, 24008, 24279, 24548, 24812, 25073,
+  25330, 25583, 25833, 26078, 26320, 26557, 26791, 27020, 27246, 27467, 27684, 27897,
+  28106, 28311, 28511, 28707, 28899, 29086, 29269, 29448, 29622, 29792, 29957, 30118,
+  30274, 30425, 30572, 30715, 30853, 30986, 31114, 31238, 31357, 31471, 31581, 31686,
+  31786, 31881, 31972, 32058, 32138, 32214, 32286, 32352, 32413, 32470, 32522, 32568,
+  32610, 32647, 32679, 32706, 32729, 32746, 32758, 32766, 32768
+};
+
+// atan() from 0 to 1 in 128 steps, as binary angles (8192 is 45 degrees)
+static const uint16_t arctanTable[129] PROGMEM = {
+  0, 81, 163, 244, 326, 407, 489, 570, 651, 732, 813, 894,
+  975, 1056, 1136, 1217, 1297, 1377, 1457, 1537, 1617, 1696, 1775, 1854,
+  1933, 2012, 2090, 2168, 2246, 2324, 2401, 2478, 2555, 2632, 2708, 2784,
+  2860, 2935, 3010, 3085, 3159, 3233, 3307, 3380, 3453, 3526, 3599, 3670,
+  3742, 3813, 3884, 3955, 4025, 4095, 4164, 4233, 4302, 4370, 4438, 4505,
+  4572, 4639, 4705, 4771, 4836, 4901, 4966, 5030, 5094, 5157, 5220, 5282,
+  5344, 5406, 5467, 5528, 5589, 5649, 5708, 5768, 5826, 5885, 5943, 6000,
+  6058, 6114, 6171, 6227, 6282, 6337, 6392, 6446, 6500, 6554, 6607, 6660,
+  6712, 6764, 6815, 6867, 6917, 6968, 7018, 7068, 7117, 7166, 7214, 7262,
+  7310, 7358, 7405, 7451, 7498, 7544, 7589, 7635, 7679, 7724, 7768, 7812,
+  7856, 7899, 7942, 7984, 8026, 8068, 8110, 8151, 8192
+};
+
+int16_t FastTrig::sin(uint16_t angle)
+{
+  // Mirror the second and fourth quadrant onto the first, the lower half of the turn is the negative of the upper half
+  uint16_t offset = angle & 0x3FFF;
+  if (angle & 0x4000)
+  {
+    offset = 0x4000 - offset;
+  }
+
+  byte index = offset >> 7;
+  byte fraction = offset & 0x7F;
+  uint16_t value = pgm_read_word(&sineTable[index]);
+  if (fraction != 0)
+  {
+    uint16_t next = pgm_read_word(&sineTable[index + 1]);
+    value += ((unsigned long)(next - value) * fraction + 64) >> 7;
+  }
+
+  int16_t result = (value + 1) >> 1;
+  return (angle & 0x8000) ? -result : result;
+}
+
+int16_t FastTrig::cos(uint16_t angle)
+{
+  return sin(angle + 0x4000);
+}
+
+int16_t FastTrig::atan2(long y, long x)
+{
+  if ((x == 0) && (y == 0))
+  {
+    return 0;
+  }
+
+  // Reduce to the first octant, where the ratio of the smaller to the larger side is 0 to 1
+  unsigned long larger = labs(x);
+  unsigned long smaller = labs(y);
+  bool swapped = smaller > larger;
+  if (swapped)
+  {
+    unsigned long swap = larger;
+    larger = smaller;
+    smaller = swap;
+  }
+
+  // Scale the larger side to 16 bits, so the ratio can be a 16 bit division result
+  while (larger >= 0x10000UL)
+  {
+    larger >>= 1;
+    smaller >>= 1;
+  }
+  while (larger < 0x8000UL)
+  {
+    larger <<= 1;
+    smaller <<= 1;
+  }
+  uint16_t ratio = (smaller << 15) / larger;
+
+  byte index = ratio >> 8;
+  byte fraction = ratio & 0xFF;
+  uint16_t result = pgm_read_word(&arctanTable[index]);
+  if (fraction != 0)
+  {
+    uint16_t next = pgm_read_word(&arctanTable[index + 1]);
+    result += ((unsigned long)(next - result) * fraction + 128) >> 8;
+  }
+
+  // Back to the octant the vector is in
+  if (swapped)
+  {
+    result = 0x4000 - result;
+  }
+  if (x < 0)
+  {
+    result = 0x8000 - result;
+  }
+  return (int16_t)((y < 0) ? -result : result);
+}
+
+uint16_t FastTrig::isqrt(unsigned long value)
+{
+  unsigned long result = 0;
+  unsigned long bit = 1UL << 30;
+  while (bit > value)
+  {
+    bit >>= 2;
+  }
+  while (bit != 0)
+  {
+    if (value >= result + bit)
+    {
+      value -= result + bit;
+      result = (result >> 1) + bit;
+    }
+    else
+    {
+      result >>= 1;
+    }
+    bit >>= 2;
+  }
+  return result;
+}
+
+uint16_t FastTrig::fromDegrees(float degrees)
+{
+  return (uint16_t)(long)floor(degrees * 65536.0f / 360.0f + 0.5f);
+}
+
+float FastTrig::toDegrees(int16_t angle)
+{
+  return angle * 360.0f / 65536.0f;
+}
+
+#if FAST_TRIG_TIMING == 1 && defined(__AVR__)
+#include "AltAz.hpp"
+
+#define TIMING_CALLS 1000
+
+// The results go here so the calls are not optimized away
+static volatile long timingSink;
+static volatile float timingFloatSink;
+
+// Print the cycles per call of the statement, run TIMING_CALLS times with i counting up. Includes the loop.
+#define TIME_CALLS(name, statement) \
+  { \
+    unsigned long start = micros(); \
+    for (uint16_t i = 0; i < TIMING_CALLS; i++) \
+    { \
+      statement; \
+    } \
+    unsigned long cycles = (micros() - start) * (F_CPU / 1000000UL) / TIMING_CALLS; \
+    Serial.print(F(name)); \
+    Serial.print(F(": ")); \
+    Serial.print(cycles); \
+    Serial.println(F(" cycles/call")); \
+  }
+
+void FastTrig::reportTiming()
+{
+  float altitude, azimuth;
+  TIME_CALLS("Loop", timingSink = i);
+  TIME_CALLS("FastTrig::sin", timingSink = FastTrig::sin(i * 65));
+  TIME_CALLS("sin", timingFloatSink = ::sin(i * 0.00628f));
+  TIME_CALLS("FastTrig::atan2", timingSink = FastTrig::atan2(i * 7L - 3500, 2000L - i * 3L));
+  TIME_CALLS("atan2", timingFloatSink = ::atan2(i * 7.0f - 3500.0f, 2000.0f - i * 3.0f));
+  TIME_CALLS("FastTrig::isqrt", timingSink = FastTrig::isqrt(i * 4294967UL));
+  TIME_CALLS("AltAz::fromEquatorial", AltAz::fromEquatorial(i * 0.36f - 180.0f, i * 0.18f - 90.0f, 50.0f, altitude, azimuth); timingFloatSink = altitude);
+}
+#endif
+
+#endif
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Arduino.h>
+#include "Configuration_adv.hpp"
+
+#if FAST_TRIG == 1
+
+// 1.0 in the sines and cosines
+#define TRIG_ONE 16384
+
+//////////////////////////////////////////////////////////////////
+//
+// Fixed point sine, cosine and arctangent from PROGMEM tables, for the AVR boards where each float trig call
+// costs well over 100us.
+//
+// Angles are binary angles, 65536 to a turn, so they wrap around by themselves (as uint16_t) and -32768 is -180
+// degrees (as int16_t). One unit is 0.0055 degrees. Sines and cosines have 14 fractional bits (TRIG_ONE).
+// Both tables are interpolated linearly over 128 intervals:
+//   sin/cos:  within 6e-5 (interpolation 1.9e-5, the rest is rounding to 14 bits)
+//   atan2:    within 1.3 units (0.007 degrees)
+//////////////////////////////////////////////////////////////////
+class FastTrig {
+public:
+  static int16_t sin(uint16_t angle);
+  static int16_t cos(uint16_t angle);
+
+  // Angle of the vector (x, y), so that atan2(sin(a), cos(a)) is a. Returns 0 for (0, 0).
+  static int16_t atan2(long y, long x);
+
+  // Square root, rounded down.
+  static uint16_t isqrt(unsigned long value);
+
+  static uint16_t fromDegrees(float degrees);
+  static float toDegrees(int16_t angle);
+
+#if FAST_TRIG_TIMING == 1 && defined(__AVR__)
+  // Print the cycles per call of the tables and the float math library to the serial port.
+  static void reportTiming();
+#endif
+};
+
+#endif
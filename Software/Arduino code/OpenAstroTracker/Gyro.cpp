@@ -7,85 +7,149 @@
 #include "Gyro.hpp"
 
 const int MPU = 0x68; // I2C address of the MPU6050 accelerometer
+const unsigned long warmupTime = 100; // Milliseconds after waking up before the readings are stable
 
-int16_t Gyro::AcX, Gyro::AcY, Gyro::AcZ;
-int16_t Gyro::AcXOffset, Gyro::AcYOffset, Gyro::AcZOffset;
+byte Gyro::users = 0;
+unsigned long Gyro::startTime;
+unsigned long Gyro::lastSample;
+int16_t Gyro::samples[GYRO_SAMPLES][3];
+long Gyro::sums[3];
+byte Gyro::next;
+byte Gyro::count;
+int16_t Gyro::temperature;
+bool Gyro::anglesValid;
+angle_t Gyro::angles;
 
 static void Gyro::startup()
 {
+    if (users++ > 0)
+    {
+        return;
+    }
+
     // Initialize interface to the MPU6050
     LOGV1(DEBUG_INFO, "GYRO:: Starting");
     Wire.begin();
+    Wire.setClock(400000); // The MPU6050 supports fast mode, which keeps each read short
     Wire.beginTransmission(MPU);
     Wire.write(0x6B);
     Wire.write(0);
     Wire.endTransmission(true);
 
-    // read the values 100 times for them to stabilize
-    for (int i = 0; i < 100; i++)
-    {
-        Wire.beginTransmission(MPU);
-        Wire.write(0x3B); // Start with register 0x3B (ACCEL_XOUT_H)
-        Wire.endTransmission(false);
-        Wire.requestFrom(MPU, 6, true);       // Read 6 registers total, each axis value is stored in 2 registers
-        AcX = Wire.read() << 8 | Wire.read(); // X-axis value
-        AcY = Wire.read() << 8 | Wire.read(); // Y-axis value
-        AcZ = Wire.read() << 8 | Wire.read(); // Z-axis value
-    }
+    // Low pass filter the accelerometer at 10Hz (CONFIG register, DLPF_CFG 5), below half the sample rate
+    Wire.beginTransmission(MPU);
+    Wire.write(0x1A);
+    Wire.write(5);
+    Wire.endTransmission(true);
+
+    next = 0;
+    count = 0;
+    sums[0] = sums[1] = sums[2] = 0;
+    temperature = 0;
+    anglesValid = false;
+    startTime = lastSample = millis();
     LOGV1(DEBUG_INFO, "GYRO:: Started");
 }
 
 static void Gyro::shutdown()
 {
+    if ((users == 0) || (--users > 0))
+    {
+        return;
+    }
+
     LOGV1(DEBUG_INFO, "GYRO: Shutdown");
     Wire.end();
 }
 
-static angle_t Gyro::getCurrentAngles()
+// Take the next sample if it is due. Called from the main loop.
+static void Gyro::process()
+{
+    unsigned long now = millis();
+    if ((users == 0) || (now - lastSample < GYRO_SAMPLE_INTERVAL))
+    {
+        return;
+    }
+    lastSample = now;
+
+    int16_t sample[4];
+    if ((now - startTime < warmupTime) || !readSample(sample))
+    {
+        return;
+    }
+
+    // Replace the oldest sample in the ring
+    for (byte axis = 0; axis < 3; axis++)
+    {
+        if (count == GYRO_SAMPLES)
+        {
+            sums[axis] -= samples[next][axis];
+        }
+        samples[next][axis] = sample[axis];
+        sums[axis] += sample[axis];
+    }
+    next = (next + 1) % GYRO_SAMPLES;
+    if (count < GYRO_SAMPLES)
+    {
+        count++;
+    }
+    temperature = sample[3];
+    anglesValid = false;
+}
+
+// Read the acceleration and temperature registers (0x3B to 0x42) in one burst. Returns false if the MPU6050 didn't answer.
+static bool Gyro::readSample(int16_t* sample)
 {
-    const int windowSize = 16;
-    // Read the accelerometer data
-    struct angle_t result;
-    result.pitchAngle = 0;
-    result.rollAngle = 0;
-    for (int i = 0; i < windowSize; i++)
+    Wire.beginTransmission(MPU);
+    Wire.write(0x3B); // Start with register 0x3B (ACCEL_XOUT_H)
+    Wire.endTransmission(false);
+    if (Wire.requestFrom(MPU, 8, true) != 8)
     {
-        Wire.beginTransmission(MPU);
-        Wire.write(0x3B); // Start with register 0x3B (ACCEL_XOUT_H)
-        Wire.endTransmission(false);
-        Wire.requestFrom(MPU, 6, true);       // Read 6 registers total, each axis value is stored in 2 registers
-        AcX = Wire.read() << 8 | Wire.read(); // X-axis value
-        AcY = Wire.read() << 8 | Wire.read(); // Y-axis value
-        AcZ = Wire.read() << 8 | Wire.read(); // Z-axis value
-
-        // Calculating the Pitch angle (rotation around Y-axis)
-        result.pitchAngle += ((atan(-1 * AcX / sqrt(pow(AcY, 2) + pow(AcZ, 2))) * 180.0 / PI) * 2.0) / 2.0;
-        // Calculating the Roll angle (rotation around X-axis)
-        result.rollAngle += ((atan(-1 * AcY / sqrt(pow(AcX, 2) + pow(AcZ, 2))) * 180.0 / PI) * 2.0) / 2.0;
+        return false;
     }
+    for (byte i = 0; i < 4; i++)
+    {
+        sample[i] = Wire.read() << 8 | Wire.read();
+    }
+    return true;
+}
 
-    result.pitchAngle /= windowSize;
-    result.rollAngle /= windowSize;
+static angle_t Gyro::getCurrentAngles()
+{
+    if (!anglesValid)
+    {
+        angles.pitchAngle = 0;
+        angles.rollAngle = 0;
+        if (count > 0)
+        {
+            // The sums are the average scaled by the sample count, which doesn't change the angles
+            float x = sums[0];
+            float y = sums[1];
+            float z = sums[2];
+
+            // Calculating the Pitch angle (rotation around Y-axis)
+            angles.pitchAngle = atan(-x / sqrt(y * y + z * z)) * 180.0 / PI;
+            // Calculating the Roll angle (rotation around X-axis)
+            angles.rollAngle = atan(-y / sqrt(x * x + z * z)) * 180.0 / PI;
 #if GYRO_AXIS_SWAP == 1
-    float temp = result.pitchAngle;
-    result.pitchAngle = result.rollAngle;
-    result.rollAngle = temp;
+            float temp = angles.pitchAngle;
+            angles.pitchAngle = angles.rollAngle;
+            angles.rollAngle = temp;
 #endif
-    return result;
+        }
+        anglesValid = true;
+    }
+    return angles;
 }
 
 static float Gyro::getCurrentTemperature()
 {
-    // Read the temperature data
-    float result = 0.0;
-    int16_t tempValue;
-    Wire.beginTransmission(MPU);
-    Wire.write(0x41); // Start with register 0x41 (TEMP_OUT_H)
-    Wire.endTransmission(false);
-    Wire.requestFrom(MPU, 2, true);             // Read 2 registers total, the temperature value is stored in 2 registers
-    tempValue = Wire.read() << 8 | Wire.read(); // Raw Temperature value
-    // Calculating the actual temperature value
-    result = float(tempValue) / 340 + 36.53;
-    return result;
+    // Calculating the actual temperature value from the raw value of the last sample
+    return float(temperature) / 340 + 36.53;
+}
+
+static bool Gyro::hasSample()
+{
+    return (users > 0) && (count > 0);
 }
 #endif
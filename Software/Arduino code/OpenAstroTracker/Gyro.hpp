@@ -5,16 +5,33 @@
 #if GYRO_LEVEL == 1
 struct angle_t { float pitchAngle; float rollAngle; };
 
+// The MPU6050 is sampled from Mount::loop() by process(), one short I2C read every GYRO_SAMPLE_INTERVAL ms
+// into a ring of the last GYRO_SAMPLES readings. The angles are those of the average acceleration in the ring,
+// so getCurrentAngles() and getCurrentTemperature() return without touching the bus.
 class Gyro 
 {
 public:
   static void startup();
   static void shutdown();
+  static void process();
   static angle_t getCurrentAngles();
   static float getCurrentTemperature();
+
+  // Returns true once a sample has been taken since the gyro was started, the angles and temperature are 0 before.
+  static bool hasSample();
   
 private:
-  static int16_t AcX, AcY, AcZ;
-  static int16_t AcXOffset, AcYOffset, AcZOffset;
+  static bool readSample(int16_t* sample);
+
+  static byte users;    // The CAL and INFO menus and levelling can all have the gyro started
+  static unsigned long startTime;
+  static unsigned long lastSample;
+  static int16_t samples[GYRO_SAMPLES][3];
+  static long sums[3];  // Of the samples in the ring
+  static byte next;
+  static byte count;
+  static int16_t temperature;
+  static bool anglesValid;
+  static angle_t angles;
 };
-#endif
\ No newline at end of file
+#endif
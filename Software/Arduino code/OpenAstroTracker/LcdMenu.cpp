@@ -19,7 +19,7 @@ LcdMenu::LcdMenu(byte cols, byte rows, int maxItems) : _lcd(8, 9, 4, 5, 6, 7) {
   _lastDisplay[1] = "";
   _menuItems = new MenuItem * [maxItems];  
 
-  _brightness = EPROMStore::Storage()->read(16);
+  _brightness = EPROMStore::Storage()->config().brightness;
   LOGV2(DEBUG_INFO, "LCD: Brightness from EEPROM is %d", _brightness);
   // pinMode(10, OUTPUT);
   // analogWrite(10, _brightness);
@@ -87,7 +87,8 @@ void LcdMenu::setBacklightBrightness(int level, bool persist) {
   LOGV2(DEBUG_INFO, "LCD: Wrote %d as brightness", _brightness  );
   if (persist) {
     LOGV2(DEBUG_INFO, "LCD: Saving %d as brightness", (_brightness & 0x00FF));
-    EPROMStore::Storage()->update(16, (byte)(_brightness & 0x00FF));
+    EPROMStore::Storage()->config().brightness = (byte)(_brightness & 0x00FF);
+    EPROMStore::Storage()->configChanged();
   }
 }
 
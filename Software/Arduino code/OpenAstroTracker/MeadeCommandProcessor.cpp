@@ -1,6 +1,7 @@
 #include "MeadeCommandProcessor.hpp"
 #include "Configuration_adv.hpp"
 #include "Utility.hpp"
+#include "EPROMStore.hpp"
 #include "WifiControl.hpp"
 
 /////////////////////////////////////////////////////////////////////////////////////////
@@ -69,6 +70,16 @@
 //      Returns: HH:MM:SS
 //               Where HH is hour, MM is minutes, SS is seconds.
 //
+// :GA#
+//      Get Current Altitude
+//      Returns: sDD*MM#
+//               Where s is + or -, DD is degrees, MM is minutes.
+//
+// :GZ#
+//      Get Current Azimuth
+//      Returns: DDD*MM#
+//               Where DDD is degrees from north through east, MM is minutes.
+//
 // -- GET Extensions --
 // :GIS#
 //      Get DEC or RA Slewing
@@ -88,7 +99,9 @@
 //               Idle,--T--,11219,0,927,071906,+900000,#
 //                 |    |     |   |  |     |      |    
 //                 |    |     |   |  |     |      |    
-//                 |    |     |   |  |     |      |    
+//                 |    |     |   |  |     |      |    [7] * 'PosLost' if a motor stalled and the position is no longer known (sync or home to clear)
+//                 |    |     |   |  |     |      |        * 'FlipNeeded' if tracking has turned the RA ring past the meridian flip limit (see :XGW)
+//                 |    |     |   |  |     |      |        * 'Limit' if tracking or a pass was stopped at a limit of the mount (see :XLSH, :XLSE). The status is 'Fault' then.
 //                 |    |     |   |  |     |      +------------------ [6] The current DEC position
 //                 |    |     |   |  |     +------------------------- [5] The current RA position
 //                 |    |     |   |  +------------------------------- [4] The Tracking stepper position
@@ -100,9 +113,10 @@
 //                 |                                                      Third character is TRK slewing state ('T' is Tracking, '-' is stopped). 
 //                 |                                                      * Fourth character is AZ slewing state ('Z' and 'z' is adjusting, '-' is stopped). 
 //                 |                                                      * Fifth character is ALT slewing state ('A' and 'a' is adjusting, '-' is stopped). 
-//                 +------------------------------------------------- [0] The mount status. One of 'Idle', 'Parked', 'Parking', 'Guiding', 'SlewToTarget', 'FreeSlew', 'ManualSlew', 'Tracking', 'Homing'
+//                 +------------------------------------------------- [0] The mount status. One of 'Idle', 'Parked', 'Parking', 'Guiding', 'SlewToTarget', 'FreeSlew', 'ManualSlew', 'Tracking', 'Homing', 'Following', 'Fault'
 //
 //       * Az and Alt are optional. The string may only be 3 characters long
+//       * PosLost is only present when set. 'Fault' means a slew was stopped because a motor stalled (TMC2209 with COLLISION_DETECTION).
 //
 //
 // : Gt#
@@ -160,7 +174,7 @@
 //      Set Site Date
 //      This sets the date
 //      Where HHMM is the month, DD is teh day and YY is the year since 2000.
-//      CURRENTLY IGNORED.
+//      Only used to convert J2000 coordinates (see :XSEn#).
 //      Returns: 1Updating Planetary Data 
 //
 // -- SET Extensions --
@@ -195,12 +209,35 @@
 //      Where s is one of 'S', 'M', 'C', or 'G' in order of decreasing speed
 //      Returns: nothing
 //------------------------------------------------------------------
+// TRACKING RATE FAMILY
+//
+// :TQ#
+//      Select sidereal tracking rate
+//      Returns: nothing
+//
+// :TL#
+//      Select lunar tracking rate
+//      Returns: nothing
+//
+// :TS#
+//      Select solar tracking rate
+//      Returns: nothing
+//
+// -- TRACKING RATE Extensions --
+// :TK#
+//      Select King tracking rate
+//      Sidereal, corrected for the average refraction at the target.
+//      Returns: nothing
+//
+//------------------------------------------------------------------
 // MOVEMENT FAMILY
 //
 // :MS#
 //      Start Slew to Target (Asynchronously)
 //      This starts slewing the scope to the target RA and DEC coordinates and returns immediately.
-//      Returns: 0
+//      Returns: 0 if the slew started
+//               1Below horizon#    if the target is below the horizon mask (see :XLSH)
+//               2Out of reach#     if the target is outside the axis limits (see :XLSE)
 //
 // -- MOVEMENT Extensions --
 //
@@ -234,6 +271,11 @@
 //      Where n.nn is a signed floating point number representing the number of arcminutes to raise or lower the mount.
 //      Returns: nothing
 //
+// :MF#
+//      Meridian flip
+//      Slew to the current position on the other side of the pier. Tracking continues.
+//      Returns: "1" if the flip started, "0" if the mount is not tracking, is busy or the firmware is built without MERIDIAN_FLIP
+//
 //------------------------------------------------------------------
 // SYNC FAMILY
 //
@@ -313,6 +355,12 @@
 //      Get the absolute tracking speed of the mount.
 //      Returns: float
 //
+// :XGTR#
+//      Get Tracking rate
+//      Get the selected tracking rate and the RA and DEC rate offsets in arcseconds per second.
+//      Where the rate is 0 for sidereal, 1 for lunar, 2 for solar and 3 for King.
+//      Returns: n,ra,dec#
+//
 // :XGH#
 //      Get HA
 //      Get the current HA of the mount.
@@ -336,6 +384,43 @@
 //      Get the current LST of the mount.
 //      Returns: HHMMSS
 //
+// :XGP#
+//      Get mount profile
+//      Get the index and name of the active profile of calibration values.
+//      Returns: n,name#
+//
+// :XGE#
+//      Get epoch
+//      Get the epoch of the coordinates the mount is given and reports.
+//      Returns: JNow#     - coordinates of date
+//      Returns: J2000#    - J2000 coordinates, corrected for precession and nutation to the date set with :SC
+//
+// :XGF#
+//      Get refraction tracking
+//      Returns: 1# if the tracking rates are corrected for refraction, 0# if not
+//
+// :XGI#
+//      Get pier side
+//      Returns: c,t# where c is the side the mount is on now and t the side the last goto chose. 1 is the normal side,
+//               2 the side with RA and DEC turned around. With PIER_SIDE_SELECTION, t is the side that got there sooner.
+//
+// :XGW#
+//      Get meridian flip state
+//      Returns: l.ll,a,f,h.hh# where l.ll is the flip limit in hours west of home, a is 1 if the mount flips by itself,
+//               f is 1 if a flip is needed and h.hh is how many hours west of home the RA ring is now.
+//               0,0,0,h.hh# if the firmware is built without MERIDIAN_FLIP
+//
+// :XGAn#
+//      Get slew ramp
+//      Where n is the slew rate preset (1 Guide, 2 Center, 3 Find, 4 Slew).
+//      Returns: a.aa,d.dd# where a.aa and d.dd are the acceleration and deceleration as fractions of the maximum acceleration.
+//               0# if the firmware is built without MANUAL_SLEW_RAMPS
+//
+// :XGPn#
+//      Get mount profile name
+//      Where n is the profile index (0-3).
+//      Returns: name#     - empty if the profile is not in use
+//
 // :XSBn#
 //      Set Backlash correction steps 
 //      Sets the number of steps the RA stepper motor needs to overshoot and backtrack when slewing east.
@@ -375,6 +460,151 @@
 //      Set the speed of the DEC motor, immediately. Must be in manual slewing mode.
 //      Returns: nothing
 //
+// :XSPn#
+//      Set mount profile
+//      Switch to another set of steps, speed factor, backlash, location and level offsets.
+//      Where n is the profile index (0-3). A profile that is not in use yet starts as a copy of the active one.
+//      Returns: "1" if switched, "0" if the mount is moving, not at home or n is not a profile
+//
+// :XSEn#
+//      Set epoch
+//      Set the epoch of the coordinates the mount is given and reports.
+//      Where n is 0 for JNow, 1 for J2000.
+//      Returns: "1" if set, "0" if the firmware is built without EPOCH_CONVERSION
+//
+// :XSORn.nnn#
+//      Set RA tracking rate offset
+//      Track a target that moves against the stars, like a comet. Applies on top of the selected tracking rate.
+//      Where n.nnn is the RA motion in arcseconds per second, positive towards the east.
+//      Returns: nothing
+//
+// :XSODn.nnn#
+//      Set DEC tracking rate offset
+//      Where n.nnn is the DEC motion in arcseconds per second, positive towards the north.
+//      Returns: nothing
+//
+// :XSFn#
+//      Set refraction tracking
+//      Correct the RA and DEC tracking rates for atmospheric refraction, which matters near the horizon.
+//      Where n is '1' to turn it on, otherwise turn it off.
+//      Returns: "1" if set, "0" if the firmware is built without REFRACTION_TRACKING
+//
+// :XSWl.ll#
+//      Set meridian flip limit
+//      Where l.ll is how many hours west of home the RA ring may turn while tracking before a flip is needed (6 to 12).
+//      Returns: "1" if set, "0" if the firmware is built without MERIDIAN_FLIP
+//
+// :XSWAn#
+//      Set automatic meridian flip
+//      Where n is '1' to flip when the limit is reached, otherwise only report that a flip is needed (see :GX, :XGW and :MF).
+//      Returns: "1" if set, "0" if the firmware is built without MERIDIAN_FLIP
+//
+// :XSAn,a.aa,d.dd#
+//      Set slew ramp
+//      Where n is the slew rate preset (1 Guide, 2 Center, 3 Find, 4 Slew) and a.aa and d.dd are the acceleration
+//      and deceleration of manual slews at that rate, as fractions of the maximum acceleration (0.01 to 1).
+//      Returns: "1" if set, "0" if the firmware is built without MANUAL_SLEW_RAMPS
+//
+// :XSNname#
+//      Set mount profile name
+//      Rename the active profile. Where name is up to 7 characters.
+//      Returns: nothing
+//
+// :XPG#
+//      Get pointing model
+//      Get the number of sync points and the fitted mount error terms, in arcseconds: index errors IH and ID,
+//      collimation CH, axis non-perpendicularity NP and polar axis offsets MA (left/right) and ME (up/down).
+//      Returns: n,IH,ID,CH,NP,MA,ME#     - 0# if the pointing model is disabled
+//
+// :XPC#
+//      Clear pointing model
+//      Forget the sync points. The next sync sets the mount position again.
+//      Returns: nothing
+//
+// :XTAt,h.hhhhhh,d.dddddd#
+//      Add trajectory waypoint
+//      Add a waypoint of a satellite or other fast mover to the trajectory the mount follows. Waypoints must be added
+//      in time order. The pass is followed on the pier side of its first waypoint. Waypoints may be added while following,
+//      up to TRAJECTORY_POINTS ahead of the mount. Put the first one far enough ahead for the mount to get there.
+//      Where t is the time in milliseconds after the start of the pass (:XTS), h.hhhhhh is RA in decimal hours
+//      and d.dddddd is DEC in decimal degrees, in the mount's epoch.
+//      Returns: "1" if added, "0" if the trajectory is full, out of order, DEC is out of range, or the firmware is built without TRAJECTORY_FOLLOWING
+//
+// :XLT#
+//      Check target
+//      Check whether the target RA and DEC can be reached, without slewing.
+//      Returns: 0, 1 or 2 as for :MS#
+//
+// :XLGHn#
+//      Get horizon mask
+//      Where n is the sector (0-11). Sector n covers azimuths n x 30 to (n + 1) x 30 degrees, from north through east.
+//      Returns: a# where a is the lowest altitude in degrees the mount may point at in the sector, empty if it is not masked
+//
+// :XLSHn,a#
+//      Set horizon mask
+//      Where n is the sector (0-11) and a the lowest altitude in degrees. Without a, the sector is not masked.
+//      Stored in EEPROM. Returns: "1" if set, "0" if the firmware is built without MOUNT_LIMITS
+//
+// :XLGE#
+//      Get axis limits
+//      Returns: e.e,w.w,p,m# where e.e and w.w are the hours the RA ring may turn east and west of home, and p and m
+//               the degrees the DEC axis may turn from home towards positive and negative steps.
+//
+// :XLSEe.e,w.w,p,m#
+//      Set axis limits
+//      Values as for :XLGE#, 0 for the configured default. Stored in EEPROM.
+//      Returns: "1" if set, "0" if the firmware is built without MOUNT_LIMITS
+//
+// :XTS#
+//      Start following the trajectory
+//      With MOUNT_LIMITS, the pass stops with a limit fault (see :GX) when it is about to leave the axis limits or the horizon.
+//      Returns: "1" if started, "0" if there are no waypoints or the mount is busy parking or homing
+//
+// :XTC#
+//      Stop following and clear the trajectory
+//      The mount stops where it is and keeps tracking.
+//      Returns: nothing
+//
+// :XTG#
+//      Get trajectory status
+//      Returns: f,n,t# where f is 1 while following, n the number of waypoints held and t the milliseconds since the start of the pass
+//
+// :XAS#
+//      Start polar alignment
+//      Start closed loop polar alignment with the azimuth and altitude motors. The mount waits for a measurement (:XAM).
+//      Returns: "1" if started, "0" if the firmware is built without AZIMUTH_ALTITUDE_MOTORS or POLAR_ALIGNMENT
+//
+// :XAMa.aa,l.ll#
+//      Polar axis measured
+//      Where a.aa and l.ll are the azimuth and altitude corrections the polar axis needs in arcminutes, with the signs
+//      of :MAZ and :MAL. The mount makes the correction, then waits for the next measurement (see :XAG).
+//      Returns: the state as for :XAG#, "0" if the firmware is built without AZIMUTH_ALTITUDE_MOTORS or POLAR_ALIGNMENT
+//
+// :XAG#
+//      Get polar alignment progress
+//      Returns: s,i,a.aa,l.ll# where s is the state (0 idle, 1 correcting, 2 waiting for a measurement, 3 aligned,
+//               4 not aligned after POLAR_ALIGN_MAX_ITERATIONS corrections), i the number of corrections made and
+//               a.aa and l.ll the last measured azimuth and altitude corrections in arcminutes.
+//
+// :XAQ#
+//      Stop polar alignment
+//      Stops the azimuth and altitude motors.
+//      Returns: nothing
+//
+// :XVS#
+//      Start levelling
+//      Move the altitude motor until the gyro pitch is within AUTO_LEVEL_TOLERANCE of the pitch offset.
+//      Returns: "1" if started, "0" if the firmware is built without GYRO_LEVEL, AZIMUTH_ALTITUDE_MOTORS or AUTO_LEVEL
+//
+// :XVG#
+//      Get levelling progress
+//      Returns: s,n,p.pp# where s is 0 idle, 1 levelling, 2 level or 3 not level after AUTO_LEVEL_MAX_MOVES moves,
+//               n the number of moves made and p.pp the last pitch error in degrees.
+//
+// :XVQ#
+//      Stop levelling
+//      Returns: nothing
+//
 /////////////////////////////////////////////////////////////////////////////////////////
 
 MeadeCommandProcessor* MeadeCommandProcessor::_instance = nullptr;
@@ -443,6 +673,22 @@ String MeadeCommandProcessor::handleMeadeGetInfo(String inCmd) {
 
     case 'X': return _mount->getStatusString() + "#";
 
+    case 'A':
+    case 'Z': {
+      float altitude, azimuth;
+      _mount->getCurrentAltAz(altitude, azimuth);
+      char achBuffer[20];
+      if (cmdOne == 'A') {
+        long minutes = lround(fabs(altitude) * 60);
+        sprintf(achBuffer, "%c%02d*%02d#", altitude >= 0 ? '+' : '-', int(minutes / 60), int(minutes % 60));
+      }
+      else {
+        long minutes = lround(azimuth * 60) % (360 * 60L);
+        sprintf(achBuffer, "%03d*%02d#", int(minutes / 60), int(minutes % 60));
+      }
+      return String(achBuffer);
+    }
+
     case 'I':
     {
       String retVal = "";
@@ -608,6 +854,9 @@ String MeadeCommandProcessor::handleMeadeSetInfo(String inCmd) {
     return "1";
   }
   else if (inCmd[0] == 'C') { // Set Date (MM/DD/YY) :SC04/30/20#
+#if EPOCH_CONVERSION == 1
+    _mount->setDate(2000 + inCmd.substring(7, 9).toInt(), inCmd.substring(1, 3).toInt(), inCmd.substring(4, 6).toInt());
+#endif
     return "1Updating Planetary Data#"; // 
   }
   else {
@@ -620,9 +869,19 @@ String MeadeCommandProcessor::handleMeadeSetInfo(String inCmd) {
 /////////////////////////////
 String MeadeCommandProcessor::handleMeadeMovement(String inCmd) {
   if (inCmd[0] == 'S') {
-    _mount->startSlewingToTarget();
+    switch (_mount->startSlewingToTarget()) {
+      case TARGET_BELOW_HORIZON: return "1Below horizon#";
+      case TARGET_OUT_OF_REACH: return "2Out of reach#";
+    }
     return "0";
   }
+  else if (inCmd[0] == 'F') {
+#if MERIDIAN_FLIP == 1
+    return _mount->startMeridianFlip() ? "1" : "0";
+#else
+    return "0";
+#endif
+  }
   else if (inCmd[0] == 'T') {
     if (inCmd.length() > 1) {
       if (inCmd[1] == '1') {
@@ -753,6 +1012,9 @@ String MeadeCommandProcessor::handleMeadeExtraCommands(String inCmd) {
       return String(_mount->getSpeedCalibration(), 5) + "#";
     }
     else if (inCmd[1] == 'T') {
+      if (inCmd[2] == 'R') {
+        return String(_mount->getTrackingRate()) + "," + String(_mount->getTrackingRateOffset(RA_STEPS), 4) + "," + String(_mount->getTrackingRateOffset(DEC_STEPS), 4) + "#";
+      }
       return String(_mount->getSpeed(TRACKING), 7) + "#";
     }
     else if (inCmd[1] == 'B') {
@@ -774,6 +1036,46 @@ String MeadeCommandProcessor::handleMeadeExtraCommands(String inCmd) {
       sprintf(scratchBuffer, "%02d%02d%02d#", _mount->LST().getHours(), _mount->LST().getMinutes(), _mount->LST().getSeconds());
       return String(scratchBuffer);
     }
+    else if (inCmd[1] == 'P') {
+      if (inCmd.length() > 2) {
+        return _mount->getProfileName(inCmd.substring(2).toInt()) + "#";
+      }
+      return String(_mount->getProfile()) + "," + _mount->getProfileName(_mount->getProfile()) + "#";
+    }
+    else if (inCmd[1] == 'F') {
+#if REFRACTION_TRACKING == 1
+      return _mount->isRefractionTracking() ? "1#" : "0#";
+#else
+      return "0#";
+#endif
+    }
+    else if (inCmd[1] == 'A') {
+#if MANUAL_SLEW_RAMPS == 1
+      float acceleration, deceleration;
+      _mount->getSlewRamp(inCmd.substring(2).toInt(), acceleration, deceleration);
+      return String(acceleration, 2) + "," + String(deceleration, 2) + "#";
+#else
+      return "0#";
+#endif
+    }
+    else if (inCmd[1] == 'I') {
+      return String(_mount->getPierSide()) + "," + String(_mount->getTargetPierSide()) + "#";
+    }
+    else if (inCmd[1] == 'W') {
+#if MERIDIAN_FLIP == 1
+      return String(_mount->getFlipLimit(), 2) + "," + String(_mount->isAutoFlip() ? 1 : 0) + "," + String(_mount->isFlipNeeded() ? 1 : 0) + "," + String(_mount->getRAAxisHours(), 2) + "#";
+#else
+      return "0,0,0," + String(_mount->getRAAxisHours(), 2) + "#";
+#endif
+    }
+    else if (inCmd[1] == 'E') {
+#if EPOCH_CONVERSION == 1
+      if (_mount->getEpoch() == EPOCH_J2000) {
+        return "J2000#";
+      }
+#endif
+      return "JNow#";
+    }
     else if (inCmd[1] == 'N') {
 #ifdef WIFI_ENABLED
       return wifiControl.getStatus() + "#";
@@ -804,6 +1106,208 @@ String MeadeCommandProcessor::handleMeadeExtraCommands(String inCmd) {
     else if (inCmd[1] == 'B') {
       _mount->setBacklashCorrection(inCmd.substring(2).toInt());
     }
+    else if (inCmd[1] == 'P') {
+      return _mount->selectProfile(inCmd.substring(2).toInt()) ? "1" : "0";
+    }
+    else if (inCmd[1] == 'N') {
+      _mount->setProfileName(inCmd.substring(2));
+    }
+    else if (inCmd[1] == 'O') {
+      if (inCmd[2] == 'R') {
+        _mount->setTrackingRateOffset(RA_STEPS, inCmd.substring(3).toFloat());
+      }
+      else if (inCmd[2] == 'D') {
+        _mount->setTrackingRateOffset(DEC_STEPS, inCmd.substring(3).toFloat());
+      }
+    }
+    else if (inCmd[1] == 'F') {
+#if REFRACTION_TRACKING == 1
+      _mount->setRefractionTracking(inCmd[2] == '1');
+      return "1";
+#else
+      return "0";
+#endif
+    }
+    else if (inCmd[1] == 'W') {
+#if MERIDIAN_FLIP == 1
+      if (inCmd[2] == 'A') {
+        _mount->setAutoFlip(inCmd[3] == '1');
+      }
+      else {
+        _mount->setFlipLimit(inCmd.substring(2).toFloat());
+      }
+      return "1";
+#else
+      return "0";
+#endif
+    }
+    else if (inCmd[1] == 'E') {
+#if EPOCH_CONVERSION == 1
+      _mount->setEpoch(inCmd.substring(2).toInt());
+      return "1";
+#else
+      return "0";
+#endif
+    }
+    else if (inCmd[1] == 'A') {
+#if MANUAL_SLEW_RAMPS == 1
+      int first = inCmd.indexOf(',');
+      int second = inCmd.indexOf(',', first + 1);
+      if ((first < 0) || (second < 0)) {
+        return "0";
+      }
+      _mount->setSlewRamp(inCmd.substring(2, first).toInt(), inCmd.substring(first + 1, second).toFloat(), inCmd.substring(second + 1).toFloat());
+      return "1";
+#else
+      return "0";
+#endif
+    }
+  }
+  else if (inCmd[0] == 'P') { // Pointing model
+    if (inCmd[1] == 'G') {
+#if POINTING_MODEL == 1
+      String model(_mount->pointingModel().points());
+      for (byte i = 0; i < MODEL_TERMS; i++) {
+        model += "," + String((long)_mount->pointingModel().term(i));
+      }
+      return model + "#";
+#else
+      return "0#";
+#endif
+    }
+    else if (inCmd[1] == 'C') {
+#if POINTING_MODEL == 1
+      _mount->clearPointingModel();
+#endif
+    }
+  }
+  else if (inCmd[0] == 'L') { // Limits
+#if MOUNT_LIMITS == 1
+    if (inCmd[1] == 'T') {
+      return String(_mount->checkTarget());
+    }
+    else if ((inCmd[1] == 'G') && (inCmd[2] == 'H')) {
+      int altitude = _mount->getHorizon(inCmd.substring(3).toInt());
+      return ((altitude == HORIZON_NONE) ? String() : String(altitude)) + "#";
+    }
+    else if ((inCmd[1] == 'S') && (inCmd[2] == 'H')) {
+      int comma = inCmd.indexOf(',');
+      bool masked = (comma > 0) && (comma < (int)inCmd.length() - 1);
+      _mount->setHorizon(inCmd.substring(3, comma > 0 ? comma : inCmd.length()).toInt(), masked ? inCmd.substring(comma + 1).toInt() : HORIZON_NONE);
+      return "1";
+    }
+    else if ((inCmd[1] == 'G') && (inCmd[2] == 'E')) {
+      float raEast, raWest;
+      int decPlus, decMinus;
+      _mount->getAxisLimits(raEast, raWest, decPlus, decMinus);
+      return String(raEast, 1) + "," + String(raWest, 1) + "," + String(decPlus) + "," + String(decMinus) + "#";
+    }
+    else if ((inCmd[1] == 'S') && (inCmd[2] == 'E')) {
+      float values[4] = { 0, 0, 0, 0 };
+      int start = 3;
+      for (byte i = 0; i < 4; i++) {
+        int end = inCmd.indexOf(',', start);
+        values[i] = inCmd.substring(start, end < 0 ? inCmd.length() : end).toFloat();
+        if (end < 0) {
+          break;
+        }
+        start = end + 1;
+      }
+      _mount->setAxisLimits(values[0], values[1], values[2], values[3]);
+      return "1";
+    }
+#else
+    if (inCmd[1] == 'T') {
+      return "0";
+    }
+    else if (inCmd[1] == 'G') {
+      return "#";
+    }
+    else if (inCmd[1] == 'S') {
+      return "0";
+    }
+#endif
+  }
+  else if (inCmd[0] == 'T') { // Trajectory
+#if TRAJECTORY_FOLLOWING == 1
+    if (inCmd[1] == 'A') {
+      int raIndex = inCmd.indexOf(',') + 1;
+      int decIndex = inCmd.indexOf(',', raIndex) + 1;
+      if ((raIndex == 0) || (decIndex == 0)) {
+        return "0";
+      }
+      unsigned long time = inCmd.substring(2, raIndex - 1).toInt();
+      float ra = inCmd.substring(raIndex, decIndex - 1).toFloat();
+      float dec = inCmd.substring(decIndex).toFloat();
+      return _mount->addWaypoint(time, ra, dec) ? "1" : "0";
+    }
+    else if (inCmd[1] == 'S') {
+      return _mount->startFollowing() ? "1" : "0";
+    }
+    else if (inCmd[1] == 'C') {
+      _mount->stopFollowing();
+    }
+    else if (inCmd[1] == 'G') {
+      return String(_mount->isFollowing() ? 1 : 0) + "," + String(_mount->getWaypointCount()) + "," + String(_mount->getFollowingTime()) + "#";
+    }
+#else
+    if ((inCmd[1] == 'A') || (inCmd[1] == 'S')) {
+      return "0";
+    }
+    else if (inCmd[1] == 'G') {
+      return "0,0,0#";
+    }
+#endif
+  }
+  else if (inCmd[0] == 'A') { // Polar alignment
+#if AZIMUTH_ALTITUDE_MOTORS == 1 && POLAR_ALIGNMENT == 1
+    if (inCmd[1] == 'S') {
+      _mount->startPolarAlignment();
+      return "1";
+    }
+    else if (inCmd[1] == 'M') {
+      int altIndex = inCmd.indexOf(',') + 1;
+      if (altIndex == 0) {
+        return "0";
+      }
+      return String(_mount->polarAlignmentMeasured(inCmd.substring(2, altIndex - 1).toFloat(), inCmd.substring(altIndex).toFloat()));
+    }
+    else if (inCmd[1] == 'G') {
+      const PolarAlignment& alignment = _mount->polarAlignment();
+      return String(alignment.state()) + "," + String(alignment.iteration()) + "," + String(alignment.azError(), 2) + "," + String(alignment.altError(), 2) + "#";
+    }
+    else if (inCmd[1] == 'Q') {
+      _mount->stopPolarAlignment();
+    }
+#else
+    if ((inCmd[1] == 'S') || (inCmd[1] == 'M')) {
+      return "0";
+    }
+    else if (inCmd[1] == 'G') {
+      return "0,0,0,0#";
+    }
+#endif
+  }
+  else if (inCmd[0] == 'V') { // Levelling
+#if GYRO_LEVEL == 1 && AZIMUTH_ALTITUDE_MOTORS == 1 && AUTO_LEVEL == 1
+    if (inCmd[1] == 'S') {
+      _mount->startLevelling();
+      return "1";
+    }
+    else if (inCmd[1] == 'G') {
+      return String(_mount->getLevellingState()) + "," + String(_mount->getLevellingMoves()) + "," + String(_mount->getLevellingError(), 2) + "#";
+    }
+    else if (inCmd[1] == 'Q') {
+      _mount->stopLevelling();
+    }
+#else
+    if (inCmd[1] == 'S') {
+      return "0";
+    }
+    else if (inCmd[1] == 'G') {
+      return "0,0,0#";
+    }
+#endif
   }
   return "";
 }
@@ -862,6 +1366,21 @@ String MeadeCommandProcessor::handleMeadeSetSlewRate(String inCmd) {
   return "";
 }
 
+/////////////////////////////
+// Tracking Rates
+/////////////////////////////
+String MeadeCommandProcessor::handleMeadeTrackingRate(String inCmd) {
+  switch (inCmd[0]) {
+    case 'Q': _mount->setTrackingRate(TRACKING_SIDEREAL); break;
+    case 'L': _mount->setTrackingRate(TRACKING_LUNAR); break;
+    case 'S': _mount->setTrackingRate(TRACKING_SOLAR); break;
+    case 'K': _mount->setTrackingRate(TRACKING_KING); break;
+    default:
+    break;
+  }
+  return "";
+}
+
 String MeadeCommandProcessor::processCommand(String inCmd) {
   if (inCmd[0] == ':') {
 
@@ -885,6 +1404,7 @@ String MeadeCommandProcessor::processCommand(String inCmd) {
       case 'I': return handleMeadeInit(inCmd);
       case 'Q': return handleMeadeQuit(inCmd);
       case 'R': return handleMeadeSetSlewRate(inCmd);
+      case 'T': return handleMeadeTrackingRate(inCmd);
       case 'D': return handleMeadeDistance(inCmd);
       case 'X': return handleMeadeExtraCommands(inCmd);
       default:
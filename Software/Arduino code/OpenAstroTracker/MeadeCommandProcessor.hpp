@@ -21,6 +21,7 @@ private:
   String handleMeadeQuit(String inCmd);
   String handleMeadeDistance(String inCmd);
   String handleMeadeSetSlewRate(String inCmd);
+  String handleMeadeTrackingRate(String inCmd);
   String handleMeadeExtraCommands(String inCmd);
   Mount* _mount;
   LcdMenu* _lcdMenu;
@@ -4,7 +4,11 @@
 #include "Mount.hpp"
 #include "Utility.hpp"
 #include "EPROMStore.hpp"
-#include "Sidereal.cpp"
+#include "FastStepper.hpp"
+#include "Axis.hpp"
+#include "Sidereal.hpp"
+#include "Precession.hpp"
+#include "Gyro.hpp"
 #include "Configuration_adv.hpp"
 #include "Configuration_pins.hpp"
 
@@ -14,6 +18,7 @@
 #define STATUS_SLEWING_TO_TARGET   0B0000000000000100
 #define STATUS_SLEWING_FREE        0B0000000000000010
 #define STATUS_SLEWING_MANUAL      0B0000000100000000
+#define STATUS_FOLLOWING           0B0000001000000000
 #define STATUS_TRACKING            0B0000000000001000
 #define STATUS_PARKING             0B0000000000010000
 #define STATUS_GUIDE_PULSE         0B0000000010000000
@@ -23,6 +28,41 @@
 #define STATUS_GUIDE_PULSE_MASK    0B0000000011100000
 #define STATUS_FINDING_HOME        0B0010000000000000
 
+// Fault flags, set when a slew is stopped because a motor stalled.
+#define FAULT_STALL_RA             B00000001
+#define FAULT_STALL_DEC            B00000010
+#define FAULT_LIMIT                B00000100
+
+// Progress of moving TRK onto the slew microstep grid, see updateRAMicrostepping()
+#define RA_ALIGN_NONE              0
+#define RA_ALIGN_MOVING            1    // interruptLoop() is moving TRK onto the grid
+#define RA_ALIGN_TRACKING          2    // Tracking is moving TRK onto the grid
+#define RA_ALIGN_SWITCH            3    // TRK is on the grid, the RA driver has to be switched before RA can slew
+
+// Progress of moving DEC onto the slew microstep grid after a guide pulse, see stopGuiding()
+#define DEC_ALIGN_NONE             0
+#define DEC_ALIGN_MOVING           1    // interruptLoop() is moving DEC onto the grid
+#define DEC_ALIGN_SWITCH           2    // DEC is on the grid, its position and driver have to be switched back
+
+// The position checkpoint is journaled in the rest of the EEPROM, after the config slots.
+// A checkpoint without the valid flag is written when the steppers start moving.
+#define CHECKPOINT_JOURNAL_START   CONFIG_STORAGE_END
+#define CHECKPOINT_VALID           B00000001
+#define CHECKPOINT_TRACKING        B00000010
+// Written in every checkpoint and changed whenever its layout changes. The CRC8 alone lets 1 in 256
+// slots of unerased or random EEPROM through.
+#define CHECKPOINT_MARKER          0xC1
+
+struct PositionCheckpoint {
+  uint8_t marker;       // CHECKPOINT_MARKER
+  uint8_t state;        // CHECKPOINT_* flags
+  int32_t raPosition;
+  int32_t decPosition;
+  int32_t trkPosition;
+  uint32_t zeroPosRA;   // Angle
+  uint32_t lst;         // Angle
+};
+
 // slewingStatus()
 #define SLEWING_DEC                B00000010
 #define SLEWING_RA                 B00000001
@@ -66,42 +106,118 @@ void mountLoop(void* payload) {
   mount->interruptLoop();
 }
 
-const float siderealDegreesInHour = 14.95902778;
+// Guide pulse speeds as a multiple of the sidereal rate.
+constexpr float raGuideWestRate = RAAxis::fixedGuideRates ? 2.0f : RA_PULSE_MULTIPLIER;
+constexpr float raGuideEastRate = RAAxis::fixedGuideRates ? 0.0f : RA_PULSE_MULTIPLIER - 1.0f;
+constexpr float decGuideRate = DECAxis::fixedGuideRates ? 1.0f : DEC_PULSE_MULTIPLIER;
+
+// The sidereal rate, the sky turns west at this many arcseconds per (solar) second
+constexpr float siderealArcsecondsPerSecond = 15.041067f;
+
+// Tracking rates as a fraction of the sidereal rate, indexed by TRACKING_*
+static const float trackingRates[TRACKING_RATES] = {
+  1.0f,         // Sidereal
+  0.976327f,    // Lunar, 14.685"/s
+  0.997270f,    // Solar, 15.000"/s
+  0.999730f,    // King, 15.037"/s
+};
+
 /////////////////////////////////
 //
 // CTOR
 //
 /////////////////////////////////
 Mount::Mount(int stepsPerRADegree, int stepsPerDECDegree, LcdMenu* lcdMenu) {
-  #if RA_DRIVER_TYPE != ULN2003_DRIVER
-  _stepsPerRADegree = stepsPerRADegree * SET_MICROSTEPPING; // hier
-  #else
-  _stepsPerRADegree = stepsPerRADegree;
-  #endif
-  #if DEC_DRIVER_TYPE != ULN2003_DRIVER
-  _stepsPerDECDegree = stepsPerDECDegree * DEC_SLEW_MICROSTEPPING;
-  #else
-  _stepsPerDECDegree = stepsPerDECDegree;
-  #endif
+  _defaultStepsPerRADegree = stepsPerRADegree * RAAxis::slewMicrosteps;
+  _defaultStepsPerDECDegree = stepsPerDECDegree * DECAxis::slewMicrosteps;
   _lcdMenu = lcdMenu;
   _mountStatus = 0;
+  _faultStatus = 0;
+  _positionLost = false;
+  #if POSITION_CHECKPOINT == 1
+  _checkpointEnabled = false;
+  _checkpointValid = false;
+  _lastCheckpoint = 0;
+  _checkpointJournal = new EPROMJournal(CHECKPOINT_JOURNAL_START, EPROMStore::Storage()->length(), sizeof(PositionCheckpoint));
+  _checkpointJournal->begin();
+  #endif
+  _utc = Sidereal::buildDate();
+  #if EPOCH_CONVERSION == 1
+  _epoch = DEFAULT_EPOCH;
+  #endif
+  _trackingRate = TRACKING_SIDEREAL;
+  _raRateOffset = 0;
+  _decRateOffset = 0;
+  #if REFRACTION_TRACKING == 1
+  _refractionTracking = false;
+  _refractionRARate = 0;
+  _refractionDECRate = 0;
+  _lastRefractionUpdate = 0;
+  #endif
+  #if TRAJECTORY_FOLLOWING == 1
+  _trajectorySide = PIER_SIDE_AUTO;
+  _trajectoryStart = 0;
+  _lastTrajectoryUpdate = 0;
+  #endif
+  _targetPierSide = PIER_SIDE_NORMAL;
+  #if MANUAL_SLEW_RAMPS == 1
+  const float slewAcceleration[] = MANUAL_SLEW_ACCELERATION;
+  const float slewDeceleration[] = MANUAL_SLEW_DECELERATION;
+  for (byte i = 0; i < 4; i++) {
+    _slewAcceleration[i] = slewAcceleration[i];
+    _slewDeceleration[i] = slewDeceleration[i];
+  }
+  _manualRASpeed = 0;
+  _manualDECSpeed = 0;
+  _lastManualSlewUpdate = 0;
+  #endif
+  #if MOUNT_LIMITS == 1
+  _lastLimitCheck = 0;
+  #endif
+  #if MERIDIAN_FLIP == 1
+  _flipLimit = MERIDIAN_FLIP_LIMIT;
+  _autoFlip = (MERIDIAN_FLIP_AUTO == 1);
+  _flipNeeded = false;
+  _lastFlipCheck = 0;
+  #endif
+  _clockTick = millis();
   _lastDisplayUpdate = 0;
   _stepperWasRunning = false;
   
   #if AZIMUTH_ALTITUDE_MOTORS == 1
   _azAltWasRunning = false;
+  _azDirection = 0;
+  _altDirection = 0;
+  #endif
+  #if GYRO_LEVEL == 1 && AZIMUTH_ALTITUDE_MOTORS == 1 && AUTO_LEVEL == 1
+  _levelState = LEVEL_IDLE;
+  _levelMoves = 0;
+  _levelError = 0;
+  _levelMove = 0;
+  _levelResponse = 1.0f / 60.0f;
+  _lastLevelUpdate = 0;
   #endif
 
   _totalDECMove = 0;
   _totalRAMove = 0;
+  _trackingSpeedCalibration = 1.0;
   _moveRate = 4;
-#if RA_STEPPER_TYPE == STEP_28BYJ48
-  _backlashCorrectionSteps = 16;
-#else
-  _backlashCorrectionSteps = 0;
-#endif
+  _backlashCorrectionSteps = RAAxis::backlashSteps;
   _correctForBacklash = false;
   _slewingToHome = false;
+  #if RA_DRIVER_TYPE == TMC2209_UART
+  _trackingPhaseOffset = 0;
+  _guideStartDECPosition = 0;
+  _raAlignment = RA_ALIGN_NONE;
+  _decAlignment = DEC_ALIGN_NONE;
+  #endif
+  #if RA_DRIVER_TYPE == TMC2209_UART && DEC_DRIVER_TYPE == TMC2209_UART && USE_AUTOHOME == 1
+  _homingAxis = 0;
+  _homingPhase = 0;
+  _stallArmed = false;
+  _stallDetected = false;
+  _stallPosition = 0;
+  #endif
   readPersistentData();
 }
 
@@ -139,46 +255,37 @@ void Mount::readConfiguration()
 // readPersistentData
 //
 /////////////////////////////////
-//
-// EEPROM storage location 5 must be 0xBE for the mount to read any data
-// Location 4 indicates what has been stored so far: 00000000
-//                                                   ^^^^^^^^
-//                                                   ||||||||
-//                    Roll angle offset (19/20) -----+|||||||
-//                   Pitch angle offset (17/18) ------+||||||
-//                            Longitude (14/15) -------+|||||
-//                             Latitude (12/13) --------+||||
-//                       Backlash steps (10/11) ---------+|||
-//                           Speed factor (0/3) ----------+||
-//     DEC stepper motor steps per degree (8/9) -----------+|
-//      RA stepper motor steps per degree (6/7) ------------+
-//
+// The mount values are kept in the active profile of the EEPROM config (see MountProfile). Each has a
+// CONFIG_* flag bit that is set once the value has been stored, otherwise the configured default is used.
 void Mount::readPersistentData()
 {
-  // Read the magic marker byte and state
-  uint16_t marker = EPROMStore::Storage()->readInt16(4, 5);
+  const MountProfile& config = EPROMStore::Storage()->profile();
 
-  LOGV2(DEBUG_INFO, "Mount: EEPROM: Marker: %x ", marker);
+  LOGV3(DEBUG_INFO, "Mount: EEPROM: Profile %d (%s)", EPROMStore::Storage()->config().activeProfile, config.name);
 
-  if ((marker & 0xFF01) == 0xBE01) {
-    _stepsPerRADegree = EPROMStore::Storage()->read(6) + EPROMStore::Storage()->read(7) * 256;
+  LOGV2(DEBUG_INFO, "Mount: EEPROM: Flags: %x ", config.flags);
+
+  if (config.flags & CONFIG_RA_STEPS) {
+    _stepsPerRADegree = config.raStepsPerDegree;
     LOGV2(DEBUG_INFO,"Mount: EEPROM: RA Marker OK! RA steps/deg is %d", _stepsPerRADegree);
   }
   else{
+    _stepsPerRADegree = _defaultStepsPerRADegree;
     LOGV1(DEBUG_INFO,"Mount: EEPROM: No stored value for RA steps");
   }
 
-  if ((marker & 0xFF02) == 0xBE02) {
-    _stepsPerDECDegree = EPROMStore::Storage()->read(8) + EPROMStore::Storage()->read(9) * 256;
+  if (config.flags & CONFIG_DEC_STEPS) {
+    _stepsPerDECDegree = config.decStepsPerDegree;
     LOGV2(DEBUG_INFO,"Mount: EEPROM: DEC Marker OK! DEC steps/deg is %d", _stepsPerDECDegree);
   }
   else{
+    _stepsPerDECDegree = _defaultStepsPerDECDegree;
     LOGV1(DEBUG_INFO,"Mount: EEPROM: No stored value for DEC steps");
   }
 
   float speed = 1.0;
-  if ((marker & 0xFF04) == 0xBE04) {
-    int adjust = EPROMStore::Storage()->read(0) + EPROMStore::Storage()->read(3) * 256;
+  if (config.flags & CONFIG_SPEED) {
+    int adjust = config.speedAdjust;
     speed = 1.0 + 1.0 * adjust / 10000.0;
     LOGV3(DEBUG_INFO,"Mount: EEPROM: Speed Marker OK! Speed adjust is %d, speedFactor is %f", adjust, speed);
   }
@@ -186,46 +293,51 @@ void Mount::readPersistentData()
     LOGV1(DEBUG_INFO,"Mount: EEPROM: No stored value for speed factor");
   }
 
-  if ((marker & 0xFF08) == 0xBE08) {
-    _backlashCorrectionSteps = EPROMStore::Storage()->read(10) + EPROMStore::Storage()->read(11) * 256;
+  if (config.flags & CONFIG_BACKLASH) {
+    _backlashCorrectionSteps = config.backlashSteps;
     LOGV2(DEBUG_INFO,"Mount: EEPROM: Backlash Steps Marker OK! Backlash correction is %d", _backlashCorrectionSteps);
   }
   else {
+    _backlashCorrectionSteps = RAAxis::backlashSteps;
     LOGV1(DEBUG_INFO,"Mount: EEPROM: No stored value for backlash correction");
   }
 
-  if ((marker & 0xFF10) == 0xBE10) {
-    _latitude = 1.0f * EPROMStore::Storage()->readInt16(12, 13) / 100.0f;
+  if (config.flags & CONFIG_LATITUDE) {
+    _latitude = 1.0f * config.latitude / 100.0f;
     LOGV2(DEBUG_INFO,"Mount: EEPROM: Latitude Marker OK! Latitude is %f", _latitude);
   } 
   else {
+    _latitude = 0;
     LOGV1(DEBUG_INFO,"Mount: EEPROM: No stored value for latitude");
   }
 
-  if ((marker & 0xFF20) == 0xBE20) {
-    _longitude = 1.0f * EPROMStore::Storage()->readInt16(14, 15) / 100.0f;
+  if (config.flags & CONFIG_LONGITUDE) {
+    _longitude = 1.0f * config.longitude / 100.0f;
     LOGV2(DEBUG_INFO,"Mount: EEPROM: Longitude Marker OK! Longitude is %f", _longitude);
   } 
   else {
+    _longitude = 0;
     LOGV1(DEBUG_INFO,"Mount: EEPROM: No stored value for longitude");
   }
 
 #if GYRO_LEVEL == 1
-  if ((marker & 0xFF40) == 0xBE40) {
-    uint16_t angleValue = EPROMStore::Storage()->readInt16(17, 18);
+  if (config.flags & CONFIG_PITCH_OFFSET) {
+    uint16_t angleValue = config.pitchOffset;
     _pitchCalibrationAngle = (((long)angleValue) - 16384) / 100.0;
     LOGV3(DEBUG_INFO,"Mount: EEPROM: Pitch Offset Marker OK! Pitch Offset is %x (%f)", angleValue, _pitchCalibrationAngle);
   }
     else{
+    _pitchCalibrationAngle = 0;
     LOGV1(DEBUG_INFO,"Mount: EEPROM: No stored value for Pitch Offset");
   }
 
-  if ((marker & 0xFF80) == 0xBE80) {
-    uint16_t angleValue = EPROMStore::Storage()->readInt16(19,20);
+  if (config.flags & CONFIG_ROLL_OFFSET) {
+    uint16_t angleValue = config.rollOffset;
     _rollCalibrationAngle = (((long)angleValue) - 16384) / 100.0;
     LOGV3(DEBUG_INFO,"Mount: EEPROM: Roll Offset Marker OK! Roll Offset is %x (%f)", angleValue, _rollCalibrationAngle);
   }
   else {
+    _rollCalibrationAngle = 0;
     LOGV1(DEBUG_INFO,"Mount: EEPROM: No stored value for Roll Offset");
   }
 #endif
@@ -238,105 +350,137 @@ void Mount::readPersistentData()
 // writePersistentData
 //
 /////////////////////////////////
+// Changes the value in the active profile. It is written once the mount is idle (see EPROMStore::process()).
 void Mount::writePersistentData(int which, int val)
 {
-  uint8_t flag = 0x00;
-  int loByteLocation = 0;
-  int hiByteLocation = 0;
-
-  // If we're written something before...
-  uint8_t magicMarker = EPROMStore::Storage()->read(5);
-  LOGV4(DEBUG_INFO,"Mount: EEPROM Write: Marker is %x, flag is %x (%d)", magicMarker, flag, flag);
-  if (magicMarker == 0xBE) {
-    // ... read the current state ...
-    flag = EPROMStore::Storage()->read(4);
-    LOGV3(DEBUG_INFO,"Mount: EEPROM Write: Marker is 0xBE, flag is %x (%d)", flag, flag);
-  }
+  MountProfile& config = EPROMStore::Storage()->profile();
+
   switch (which) {
     case EEPROM_RA:
     {
-      // ... set bit 0 to indicate RA value has been written to 6/7
-      flag |= 0x01;
-      loByteLocation = 6;
-      hiByteLocation = 7;
+      config.flags |= CONFIG_RA_STEPS;
+      config.raStepsPerDegree = val;
       LOGV2(DEBUG_INFO,"Mount: EEPROM Write: Updating RA steps to %d", val);
     }
     break;
     case EEPROM_DEC:
     {
-      // ... set bit 1 to indicate DEC value has been written to 8/9
-      flag |= 0x02;
-      loByteLocation = 8;
-      hiByteLocation = 9;
+      config.flags |= CONFIG_DEC_STEPS;
+      config.decStepsPerDegree = val;
       LOGV2(DEBUG_INFO,"Mount: EEPROM Write: Updating DEC steps to %d", val);
     }
     break;
     case EEPROM_SPEED:
     {
-      // ... set bit 3 to indicate speed factor value has been written to 0/3
-      flag |= 0x04;
-      loByteLocation = 0;
-      hiByteLocation = 3;
+      config.flags |= CONFIG_SPEED;
+      config.speedAdjust = val;
       LOGV2(DEBUG_INFO,"Mount: EEPROM Write: Updating Speed factor to %d", val);
     }
     break;
     case EEPROM_BACKLASH:
     {
-      // ... set bit 4 to indicate backlash has been written to 10/11
-      flag |= 0x08;
-      loByteLocation = 10;
-      hiByteLocation = 11;
+      config.flags |= CONFIG_BACKLASH;
+      config.backlashSteps = val;
       LOGV2(DEBUG_INFO,"Mount: EEPROM Write: Updating Backlash to %d", val);
     }
-
+    break;
     case EEPROM_LATITUDE:
     {
-      // ... set bit 5 to indicate Latitude x100  has been written to 12/13
-      flag |= 0x10;
-      loByteLocation = 12;
-      hiByteLocation = 13;
+      // Latitude x100
+      config.flags |= CONFIG_LATITUDE;
+      config.latitude = val;
       LOGV2(DEBUG_INFO,"Mount: EEPROM Write: Updating Latitude to %d", val);
     }
-
+    break;
     case EEPROM_LONGITUDE:
     {
-      // ... set bit 6 to indicate Longitude x100  has been written to 14/15
-      flag |= 0x20;
-      loByteLocation = 14;
-      hiByteLocation = 15;
+      // Longitude x100
+      config.flags |= CONFIG_LONGITUDE;
+      config.longitude = val;
       LOGV2(DEBUG_INFO,"Mount: EEPROM Write: Updating Longitude to %d", val);
     }
     break;
     case EEPROM_PITCH_OFFSET:
     {
-      // ... set bit 7 to indicate pitch offset angle value has been written to 17/18
-      flag |= 0x40;
-      loByteLocation = 17;
-      hiByteLocation = 18;
+      config.flags |= CONFIG_PITCH_OFFSET;
+      config.pitchOffset = val;
       LOGV2(DEBUG_INFO,"Mount: EEPROM Write: Updating Pitch Offset to %d", val);
     }
     break;
     case EEPROM_ROLL_OFFSET:
     {
-      // ... set bit 8 to indicate pitch offset angle value has been written to 19/20
-      flag |= 0x80;
-      loByteLocation = 19;
-      hiByteLocation = 20;
+      config.flags |= CONFIG_ROLL_OFFSET;
+      config.rollOffset = val;
       LOGV2(DEBUG_INFO,"Mount: EEPROM Write: Updating Roll Offset to %d", val);
     }
     break;
+  }
+
+  EPROMStore::Storage()->configChanged();
+}
+
+/////////////////////////////////
+//
+// selectProfile
+//
+/////////////////////////////////
+// Switch to the calibration of another mount. Values the profile has not stored get their defaults.
+// The stepper positions are counted in the steps of the old calibration, so the mount has to stand still
+// at home, where they are all zero.
+bool Mount::selectProfile(byte index)
+{
+  if (isSlewingRAorDEC() || isSlewingTRK() || isGuiding() ||
+      (_stepperRA->currentPosition() != 0) || (_stepperDEC->currentPosition() != 0) || (_stepperTRK->currentPosition() != 0)) {
+    LOGV1(DEBUG_INFO, "Mount: Cannot switch profiles away from home or while moving");
+    return false;
+  }
 
+  if (!EPROMStore::Storage()->selectProfile(index)) {
+    return false;
   }
 
-  LOGV3(DEBUG_INFO,"Mount: EEPROM Write: New Marker is 0xBE, flag is %x (%d)", flag, flag);
+  LOGV2(DEBUG_INFO, "Mount: Switched to profile %d", index);
+  readPersistentData();
+  return true;
+}
 
-  EPROMStore::Storage()->update(4, flag);
-  EPROMStore::Storage()->update(5, 0xBE);
+/////////////////////////////////
+//
+// getProfile
+//
+/////////////////////////////////
+byte Mount::getProfile() const
+{
+  return EPROMStore::Storage()->config().activeProfile;
+}
 
-  EPROMStore::Storage()->update(loByteLocation, val & 0x00FF);
-  EPROMStore::Storage()->update(hiByteLocation, (val >> 8) & 0x00FF);
+/////////////////////////////////
+//
+// getProfileName
+//
+/////////////////////////////////
+String Mount::getProfileName(byte index) const
+{
+  if (index >= CONFIG_PROFILES) {
+    return "";
+  }
+  return String(EPROMStore::Storage()->config().profiles[index].name);
+}
 
-  LOGV5(DEBUG_INFO,"Mount: EEPROM Write: Wrote %x to %d and %x to %d", val & 0x00FF, loByteLocation, (val >> 8) & 0x00FF, hiByteLocation);
+/////////////////////////////////
+//
+// setProfileName
+//
+/////////////////////////////////
+void Mount::setProfileName(String name)
+{
+  MountProfile& profile = EPROMStore::Storage()->profile();
+  if (name.length() == 0) {
+    return;
+  }
+  strncpy(profile.name, name.c_str(), PROFILE_NAME_LENGTH);
+  profile.name[PROFILE_NAME_LENGTH] = 0;
+  EPROMStore::Storage()->configChanged();
 }
 
 /////////////////////////////////
@@ -348,9 +492,9 @@ void Mount::writePersistentData(int which, int val)
 void Mount::configureRAStepper(byte stepMode, byte pin1, byte pin2, byte pin3, byte pin4, int maxSpeed, int maxAcceleration)
 {
 #if NORTHERN_HEMISPHERE
-  _stepperRA = new AccelStepper(stepMode, pin4, pin3, pin2, pin1);
+  _stepperRA = new FastStepper(stepMode, pin4, pin3, pin2, pin1);
 #else
-  _stepperRA = new AccelStepper(stepMode, pin1, pin2, pin3, pin4);
+  _stepperRA = new FastStepper(stepMode, pin1, pin2, pin3, pin4);
 #endif
   _stepperRA->setMaxSpeed(maxSpeed);
   _stepperRA->setAcceleration(maxAcceleration);
@@ -359,11 +503,11 @@ void Mount::configureRAStepper(byte stepMode, byte pin1, byte pin2, byte pin3, b
 
   // Use another AccelStepper to run the RA motor as well. This instance tracks earths rotation.
 #if NORTHERN_HEMISPHERE
-  _stepperTRK = new AccelStepper(HALFSTEP, pin4, pin3, pin2, pin1);
+  _stepperTRK = new FastStepper(HALFSTEP, pin4, pin3, pin2, pin1);
 #else
-  _stepperTRK = new AccelStepper(HALFSTEP, pin1, pin2, pin3, pin4);
+  _stepperTRK = new FastStepper(HALFSTEP, pin1, pin2, pin3, pin4);
 #endif
-  _stepperTRK->setMaxSpeed(10);
+  _stepperTRK->setMaxSpeed(RAAxis::trackingMaxSpeed);
   _stepperTRK->setAcceleration(2500);
 }
 #endif
@@ -371,25 +515,27 @@ void Mount::configureRAStepper(byte stepMode, byte pin1, byte pin2, byte pin3, b
 #if RA_STEPPER_TYPE == STEP_NEMA17
 void Mount::configureRAStepper(byte stepMode, byte pin1, byte pin2, int maxSpeed, int maxAcceleration)
 {
-  _stepperRA = new AccelStepper(stepMode, pin1, pin2);
+  FastStepper* stepperRA = new FastStepper(stepMode, pin1, pin2);
+  _stepperRA = stepperRA;
   _stepperRA->setMaxSpeed(maxSpeed);
   _stepperRA->setAcceleration(maxAcceleration);
   _maxRASpeed = maxSpeed;
   _maxRAAcceleration = maxAcceleration;
 
   // Use another AccelStepper to run the RA motor as well. This instance tracks earths rotation.
-  _stepperTRK = new AccelStepper(DRIVER, pin1, pin2);
+  FastStepper* stepperTRK = new FastStepper(DRIVER, pin1, pin2);
+  _stepperTRK = stepperTRK;
   _stepperTRK->setMaxSpeed(500);
   _stepperTRK->setAcceleration(10000);
 
   #if NORTHERN_HEMISPHERE != 1
-  _stepperRA->setPinsInverted(true, false, false);
-  _stepperTRK->setPinsInverted(true, false, false);
+  stepperRA->setDirectionInverted(true);
+  stepperTRK->setDirectionInverted(true);
   #endif
   
   #if INVERT_RA_DIR == 1
-  _stepperRA->setPinsInverted(true, false, false);
-  _stepperTRK->setPinsInverted(true, false, false);
+  stepperRA->setDirectionInverted(true);
+  stepperTRK->setDirectionInverted(true);
   #endif
 }
 #endif
@@ -403,9 +549,9 @@ void Mount::configureRAStepper(byte stepMode, byte pin1, byte pin2, int maxSpeed
 void Mount::configureDECStepper(byte stepMode, byte pin1, byte pin2, byte pin3, byte pin4, int maxSpeed, int maxAcceleration)
 {
 #if NORTHERN_HEMISPHERE
-  _stepperDEC = new AccelStepper(stepMode, pin1, pin2, pin3, pin4);
+  _stepperDEC = new FastStepper(stepMode, pin1, pin2, pin3, pin4);
 #else
-  _stepperDEC = new AccelStepper(stepMode, pin4, pin3, pin2, pin1);
+  _stepperDEC = new FastStepper(stepMode, pin4, pin3, pin2, pin1);
 #endif
   _stepperDEC->setMaxSpeed(maxSpeed);
   _stepperDEC->setAcceleration(maxAcceleration);
@@ -417,7 +563,7 @@ void Mount::configureDECStepper(byte stepMode, byte pin1, byte pin2, byte pin3,
 #if AZIMUTH_ALTITUDE_MOTORS == 1
 void Mount::configureAzStepper(byte stepMode, byte pin1, byte pin2, byte pin3, byte pin4, int maxSpeed, int maxAcceleration)
 {
-  _stepperAZ = new AccelStepper(HALFSTEP, pin1, pin2, pin3, pin4);
+  _stepperAZ = new FastStepper(HALFSTEP, pin1, pin2, pin3, pin4);
   _stepperAZ->setSpeed(0);
   _stepperAZ->setMaxSpeed(maxSpeed);
   _stepperAZ->setAcceleration(maxAcceleration);
@@ -425,7 +571,7 @@ void Mount::configureAzStepper(byte stepMode, byte pin1, byte pin2, byte pin3, b
 
 void Mount::configureAltStepper(byte stepMode, byte pin1, byte pin2, byte pin3, byte pin4, int maxSpeed, int maxAcceleration)
 {
-  _stepperALT = new AccelStepper(FULLSTEP, pin1, pin2, pin3, pin4);
+  _stepperALT = new FastStepper(FULLSTEP, pin1, pin2, pin3, pin4);
   _stepperALT->setSpeed(0);
   _stepperALT->setMaxSpeed(maxSpeed);
   _stepperALT->setAcceleration(maxAcceleration);
@@ -435,14 +581,15 @@ void Mount::configureAltStepper(byte stepMode, byte pin1, byte pin2, byte pin3,
 #if DEC_STEPPER_TYPE == STEP_NEMA17
 void Mount::configureDECStepper(byte stepMode, byte pin1, byte pin2, int maxSpeed, int maxAcceleration)
 {
-  _stepperDEC = new AccelStepper(stepMode, pin1, pin2);
+  FastStepper* stepperDEC = new FastStepper(stepMode, pin1, pin2);
+  _stepperDEC = stepperDEC;
   _stepperDEC->setMaxSpeed(maxSpeed);
   _stepperDEC->setAcceleration(maxAcceleration);
   _maxDECSpeed = maxSpeed;
   _maxDECAcceleration = maxAcceleration;
   
   #if INVERT_DEC_DIR == 1
-  _stepperDEC->setPinsInverted(true, false, false);
+  stepperDEC->setDirectionInverted(true);
   #endif
 }
 #endif
@@ -455,7 +602,7 @@ void Mount::configureDECStepper(byte stepMode, byte pin1, byte pin2, int maxSpee
 #if RA_DRIVER_TYPE == TMC2209_UART
 void Mount::configureRAdriver(HardwareSerial *serial, float rsense, byte driveraddress, int rmscurrent, int stallvalue)
 {
-  _driverRA = new TMC2209Stepper(serial, rsense, driveraddress);
+  _driverRA = new TMC2209Driver(serial, rsense, driveraddress);
   _driverRA->begin();
   #if RA_AUDIO_FEEDBACK == 1
   _driverRA->en_spreadCycle(1);
@@ -472,7 +619,17 @@ void Mount::configureRAdriver(HardwareSerial *serial, float rsense, byte drivera
   //_driverRA->sedn(0b01);
   //_driverRA->SGTHRS(10);
   _driverRA->irun(31);
-  
+  #if COLLISION_DETECTION == 1
+  _driverRA->SGTHRS(stallvalue);
+  #endif
+  #if RA_AUDIO_FEEDBACK == 0 && COLLISION_DETECTION == 1
+  _driverRA->setSpreadCycleSpeed(0); // StallGuard needs StealthChop
+  #elif RA_AUDIO_FEEDBACK == 0
+  _driverRA->setSpreadCycleSpeed(SPREADCYCLE_SPEED * RAAxis::stepsPerSiderealHour(_stepsPerRADegree) / (3600.0f * SET_MICROSTEPPING));
+  #endif
+
+  // Make sure the driver is set up before the steppers start moving.
+  _driverRA->flush();
 }
 #endif
 
@@ -484,7 +641,7 @@ void Mount::configureRAdriver(HardwareSerial *serial, float rsense, byte drivera
 #if DEC_DRIVER_TYPE == TMC2209_UART
 void Mount::configureDECdriver(HardwareSerial *serial, float rsense, byte driveraddress, int rmscurrent, int stallvalue)
 {
-  _driverDEC = new TMC2209Stepper(serial, rsense, driveraddress);
+  _driverDEC = new TMC2209Driver(serial, rsense, driveraddress);
   _driverDEC->begin();
   _driverDEC->blank_time(24);
   #if DEC_AUDIO_FEEDBACK == 1
@@ -498,6 +655,14 @@ void Mount::configureDECdriver(HardwareSerial *serial, float rsense, byte driver
   _driverDEC->sedn(0b01);
   _driverDEC->SGTHRS(stallvalue);
   _driverDEC->ihold(DEC_HOLDCURRENT);
+  #if DEC_AUDIO_FEEDBACK == 0 && COLLISION_DETECTION == 1
+  _driverDEC->setSpreadCycleSpeed(0); // StallGuard needs StealthChop
+  #elif DEC_AUDIO_FEEDBACK == 0
+  _driverDEC->setSpreadCycleSpeed(SPREADCYCLE_SPEED * DECAxis::stepsPerSiderealHour(_stepsPerDECDegree) / (3600.0f * DEC_SLEW_MICROSTEPPING));
+  #endif
+
+  // Make sure the driver is set up before the steppers start moving.
+  _driverDEC->flush();
 }
 #endif
 
@@ -523,11 +688,7 @@ void Mount::setSpeedCalibration(float val, bool saveToStorage) {
 
   // The tracker simply needs to rotate at 15degrees/hour, adjusted for sidereal
   // time (i.e. the 15degrees is per 23h56m04s. 86164s/86400 = 0.99726852. 3590/3600 is the same ratio) So we only go 15 x 0.99726852 in an hour.
-  #if RA_DRIVER_TYPE == TMC2209_UART
-  _trackingSpeed = _trackingSpeedCalibration * ((_stepsPerRADegree / SET_MICROSTEPPING) * TRACKING_MICROSTEPPING) * siderealDegreesInHour / 3600.0f;
-  #else
-  _trackingSpeed = _trackingSpeedCalibration * _stepsPerRADegree * siderealDegreesInHour / 3600.0f;
-  #endif
+  _trackingSpeed = _trackingSpeedCalibration * RAAxis::siderealStepsPerSecond(_stepsPerRADegree);
   LOGV2(DEBUG_MOUNT, "Mount: New tracking speed is %f steps/sec", _trackingSpeed);
 
   if (saveToStorage) {
@@ -539,7 +700,7 @@ void Mount::setSpeedCalibration(float val, bool saveToStorage) {
 
   // If we are currently tracking, update the speed.
   if (isSlewingTRK()) {
-    _stepperTRK->setSpeed(_trackingSpeed);
+    applyTrackingRates();
   }
 }
 
@@ -591,6 +752,121 @@ void Mount::setRollCalibrationAngle(float angle)
 }
 #endif
 
+#if GYRO_LEVEL == 1 && AZIMUTH_ALTITUDE_MOTORS == 1 && AUTO_LEVEL == 1
+/////////////////////////////////
+//
+// startLevelling
+//
+/////////////////////////////////
+void Mount::startLevelling()
+{
+  if (_levelState == LEVEL_RUNNING) {
+    return;
+  }
+  LOGV2(DEBUG_MOUNT, "Mount: Start levelling to pitch %f", _pitchCalibrationAngle);
+  Gyro::startup();
+  enableAzAltMotors();
+  _levelState = LEVEL_RUNNING;
+  _levelMoves = 0;
+  _levelMove = 0;
+  _levelResponse = 1.0f / 60.0f;
+  _lastLevelUpdate = millis();
+}
+
+/////////////////////////////////
+//
+// stopLevelling
+//
+/////////////////////////////////
+void Mount::stopLevelling()
+{
+  if (_levelState != LEVEL_RUNNING) {
+    return;
+  }
+  LOGV1(DEBUG_MOUNT, "Mount: Stop levelling");
+  _levelState = LEVEL_IDLE;
+  _stepperALT->stop();
+  Gyro::shutdown();
+}
+
+/////////////////////////////////
+//
+// getLevellingState
+//
+/////////////////////////////////
+byte Mount::getLevellingState() const
+{
+  return _levelState;
+}
+
+/////////////////////////////////
+//
+// getLevellingMoves
+//
+/////////////////////////////////
+byte Mount::getLevellingMoves() const
+{
+  return _levelMoves;
+}
+
+/////////////////////////////////
+//
+// getLevellingError
+//
+/////////////////////////////////
+float Mount::getLevellingError() const
+{
+  return _levelError;
+}
+
+/////////////////////////////////
+//
+// processLevelling
+//
+/////////////////////////////////
+// Which way the altitude motor tilts the gyro depends on how it is mounted, so the response (with its sign) is taken
+// from each move that is big enough to show through the gyro noise. Responses far from the nominal 1 arcminute
+// per arcminute are more likely a bad reading than the mount, and are ignored.
+void Mount::processLevelling()
+{
+  unsigned long now = millis();
+  if (_stepperALT->isRunning()) {
+    _lastLevelUpdate = now;
+    return;
+  }
+  if (now - _lastLevelUpdate < AUTO_LEVEL_SETTLE_TIME) {
+    return;
+  }
+  _lastLevelUpdate = now;
+
+  float error = Gyro::getCurrentAngles().pitchAngle - _pitchCalibrationAngle;
+  if (fabs(_levelMove * _levelResponse) > 2 * AUTO_LEVEL_TOLERANCE) {
+    float response = (_levelError - error) / _levelMove;
+    if ((fabs(response) > 0.25f / 60.0f) && (fabs(response) < 4.0f / 60.0f)) {
+      _levelResponse = response;
+    }
+  }
+  _levelError = error;
+
+  if (fabs(error) <= AUTO_LEVEL_TOLERANCE) {
+    LOGV3(DEBUG_MOUNT, "Mount: Level after %d moves, pitch error %f", _levelMoves, error);
+    _levelState = LEVEL_DONE;
+  }
+  else if (_levelMoves >= AUTO_LEVEL_MAX_MOVES) {
+    LOGV2(DEBUG_MOUNT, "Mount: Not level after %d moves", _levelMoves);
+    _levelState = LEVEL_FAILED;
+  }
+  else {
+    _levelMove = clamp(error / _levelResponse, -1.0f * AUTO_LEVEL_MAX_MOVE, 1.0f * AUTO_LEVEL_MAX_MOVE);
+    _levelMoves++;
+    LOGV3(DEBUG_MOUNT, "Mount: Pitch error %f, moving altitude %f arcminutes", error, _levelMove);
+    moveBy(ALTITUDE_STEPS, _levelMove);
+    return;
+  }
+  Gyro::shutdown();
+}
+#endif
+
 /////////////////////////////////
 //
 // getStepsPerDegree
@@ -614,8 +890,6 @@ int Mount::getStepsPerDegree(int which)
 //
 /////////////////////////////////
 // Function to set steps per degree for each axis. This function stores the value in persistent storage.
-// The EEPROM storage location 5 is set to 0xBE if this value has ever been written. The storage location 4
-// contains a bitfield indicating which values have been stored. Currently bit 0 is used for RA and bit 1 for DEC.
 void Mount::setStepsPerDegree(int which, int steps) {
   if (which == DEC_STEPS) {
     writePersistentData(EEPROM_DEC, steps);
@@ -704,9 +978,7 @@ String Mount::getMountHardwareInfo()
 // setBacklashCorrection
 //
 /////////////////////////////////
-// Function to set steps per degree for each axis. This function stores the value in persistent storage.
-// The EEPROM storage location 5 is set to 0xBE if this value has ever been written. The storage location 4
-// contains a bitfield indicating which values have been stored. Currently bit 0 is used for RA and bit 1 for DEC.
+// Function to set the backlash correction steps. This function stores the value in persistent storage.
 void Mount::setBacklashCorrection(int steps) {
   _backlashCorrectionSteps = steps;
   writePersistentData(EEPROM_BACKLASH, steps);
@@ -725,7 +997,48 @@ void Mount::setSlewRate(int rate)
   _stepperDEC->setMaxSpeed(speedFactor[_moveRate ] * _maxDECSpeed);
   _stepperRA->setMaxSpeed(speedFactor[_moveRate ] * _maxRASpeed);
   LOGV3(DEBUG_MOUNT,"Mount::setSlewRate: new speeds are RA: %f  DEC: %f",_stepperRA->maxSpeed(), _stepperDEC->maxSpeed());
+  #if MANUAL_SLEW_RAMPS == 1
+  _stepperDEC->setAcceleration(_slewAcceleration[_moveRate - 1] * _maxDECAcceleration);
+  _stepperRA->setAcceleration(_slewAcceleration[_moveRate - 1] * _maxRAAcceleration);
+  #endif
+}
+
+/////////////////////////////////
+//
+// getSlewRate
+//
+/////////////////////////////////
+int Mount::getSlewRate() const
+{
+  return _moveRate;
+}
+
+#if MANUAL_SLEW_RAMPS == 1
+/////////////////////////////////
+//
+// setSlewRamp
+//
+/////////////////////////////////
+void Mount::setSlewRamp(int rate, float acceleration, float deceleration)
+{
+  rate = clamp(rate, 1, 4);
+  _slewAcceleration[rate - 1] = clamp(acceleration, 0.01f, 1.0f);
+  _slewDeceleration[rate - 1] = clamp(deceleration, 0.01f, 1.0f);
+  LOGV4(DEBUG_MOUNT,"Mount::setSlewRamp: rate %d accelerates at %f and decelerates at %f", rate, _slewAcceleration[rate - 1], _slewDeceleration[rate - 1]);
+}
+
+/////////////////////////////////
+//
+// getSlewRamp
+//
+/////////////////////////////////
+void Mount::getSlewRamp(int rate, float& acceleration, float& deceleration) const
+{
+  rate = clamp(rate, 1, 4);
+  acceleration = _slewAcceleration[rate - 1];
+  deceleration = _slewDeceleration[rate - 1];
 }
+#endif
 
 /////////////////////////////////
 //
@@ -737,7 +1050,6 @@ void Mount::setHA(const DayTime& haTime) {
   DayTime lst = DayTime(PolarisRAHour, PolarisRAMinute, PolarisRASecond);
   lst.addTime(haTime);
   setLST(lst);
-  _lastHASet = millis();
 }
 
 /////////////////////////////////
@@ -748,8 +1060,8 @@ void Mount::setHA(const DayTime& haTime) {
 const DayTime Mount::HA() const {
   // LOGV1(DEBUG_MOUNT_VERBOSE,"Mount: Get HA.");
   // LOGV2(DEBUG_MOUNT_VERBOSE,"Mount: Polaris adjust: %s", DayTime(PolarisRAHour, PolarisRAMinute, PolarisRASecond).ToString());
-  DayTime ha = _LST;
-  // LOGV2(DEBUG_MOUNT_VERBOSE,"Mount: LST: %s", _LST.ToString());
+  DayTime ha = LST();
+  // LOGV2(DEBUG_MOUNT_VERBOSE,"Mount: LST: %s", ha.ToString());
   ha.subtractTime(DayTime(PolarisRAHour, PolarisRAMinute, PolarisRASecond));
   LOGV2(DEBUG_MOUNT,"Mount: GetHA: LST-Polaris is HA %s", ha.ToString());
   return ha;
@@ -760,8 +1072,8 @@ const DayTime Mount::HA() const {
 // LST
 //
 /////////////////////////////////
-const DayTime& Mount::LST() const {
-  return _LST;
+const DayTime Mount::LST() const {
+  return currentLST().toDayTime();
 }
 
 /////////////////////////////////
@@ -770,9 +1082,46 @@ const DayTime& Mount::LST() const {
 //
 /////////////////////////////////
 void Mount::setLST(const DayTime& lst) {
-  _LST = lst;
-  _zeroPosRA = lst;
-  LOGV2(DEBUG_MOUNT,"Mount: Set LST and ZeroPosRA to: %s", _LST.ToString());
+  setSiderealTime(Angle::fromTime(lst));
+  _zeroPosRA = Angle::fromTime(lst);
+  LOGV2(DEBUG_MOUNT,"Mount: Set LST and ZeroPosRA to: %s", lst.ToString());
+  #if POSITION_CHECKPOINT == 1
+  checkpointPosition();
+  #endif
+}
+
+/////////////////////////////////
+//
+// updateSiderealClock
+//
+/////////////////////////////////
+// Move the clock forward by the time since the last call. Unsigned subtraction handles the millis() wrap.
+void Mount::updateSiderealClock() {
+  unsigned long now = millis();
+  Sidereal::advance(_utc, now - _clockTick);
+  _clockTick = now;
+}
+
+/////////////////////////////////
+//
+// currentLST
+//
+/////////////////////////////////
+Angle Mount::currentLST() const {
+  JulianDate now = _utc;
+  Sidereal::advance(now, millis() - _clockTick);
+  return Sidereal::gmst(now) + _lstOffset;
+}
+
+/////////////////////////////////
+//
+// setSiderealTime
+//
+/////////////////////////////////
+// The date of the clock is not known (it starts at J2000.0), the offset makes it read the given LST now.
+void Mount::setSiderealTime(Angle lst) {
+  updateSiderealClock();
+  _lstOffset = lst - Sidereal::gmst(_utc);
 }
 
 /////////////////////////////////
@@ -839,36 +1188,67 @@ DegreeTime& Mount::targetDEC() {
 /////////////////////////////////
 // Get current RA value.
 const DayTime Mount::currentRA() const {
+  Angle ra, dec;
+  currentSkyPosition(ra, dec);
+  return ra.toDayTime();
+}
+
+/////////////////////////////////
+//
+// currentRAAngle
+//
+/////////////////////////////////
+Angle Mount::currentRAAngle() const {
   // How many steps moves the RA ring one sidereal hour along. One sidereal hour moves just shy of 15 degrees
-  float stepsPerSiderealHour = _stepsPerRADegree * siderealDegreesInHour;
-  #if RA_DRIVER_TYPE == ULN2003_DRIVER
-  float hourPos = 2.0 * -_stepperRA->currentPosition() / stepsPerSiderealHour;
-  #else
-  float hourPos =  -_stepperRA->currentPosition() / stepsPerSiderealHour;
+  float stepsPerSiderealHour = RAAxis::stepsPerSiderealHour(_stepsPerRADegree);
+  float raSteps = _stepperRA->currentPosition();
+  #if TRAJECTORY_FOLLOWING == 1
+  if (isFollowing()) {
+    // The RA stepper is turning with the sky for the TRK stepper
+    raSteps -= trajectoryTracking(millis() - _trajectoryStart);
+  }
   #endif
+  float hourPos = -raSteps / stepsPerSiderealHour;
   LOGV4(DEBUG_MOUNT_VERBOSE,"CurrentRA: Steps/h    : %s (%d x %s)", String(stepsPerSiderealHour, 2).c_str(), _stepsPerRADegree, String(siderealDegreesInHour, 5).c_str());
   LOGV2(DEBUG_MOUNT_VERBOSE,"CurrentRA: RA Steps   : %d", _stepperRA->currentPosition());
   LOGV2(DEBUG_MOUNT_VERBOSE,"CurrentRA: POS        : %s", String(hourPos).c_str());
-  hourPos += _zeroPosRA.getTotalHours();
-  // LOGV2(DEBUG_MOUNT_VERBOSE,"CurrentRA: ZeroPos    : %s", _zeroPosRA.ToString());
-  // LOGV2(DEBUG_MOUNT_VERBOSE,"CurrentRA: POS (+zp)  : %s", DayTime(hourPos).ToString());
+  // Angles wrap at 24h, so there is nothing to normalize.
+  Angle ra = _zeroPosRA + Angle::fromHours(hourPos);
 
-  bool flipRA = NORTHERN_HEMISPHERE ?
-    _stepperDEC->currentPosition() < 0
-    : _stepperDEC->currentPosition() > 0;
-  if (flipRA)
+  if (isPierFlipped())
   {
-    hourPos += 12;
-    if (hourPos > 24) hourPos -= 24;
-    // LOGV2(DEBUG_MOUNT_VERBOSE,"CurrentRA: RA (+12h): %s", DayTime(hourPos).ToString());
+    ra += Angle::fromHours(12);
   }
 
-  // Make sure we are normalized
-  if (hourPos < 0) hourPos += 24;
-  if (hourPos > 24) hourPos -= 24;
+  return ra;
+}
+
+/////////////////////////////////
+//
+// isPierFlipped
+//
+/////////////////////////////////
+// Returns true if RA and DEC were turned around to reach the position (see calculateRAandDECSteppers).
+bool Mount::isPierFlipped() const {
+  return NORTHERN_HEMISPHERE ?
+    _stepperDEC->currentPosition() < 0
+    : _stepperDEC->currentPosition() > 0;
+}
 
-  // LOGV2(DEBUG_MOUNT_VERBOSE,"CurrentRA: RA Pos  -> : %s", DayTime(hourPos).ToString());
-  return hourPos;
+/////////////////////////////////
+//
+// currentSkyPosition
+//
+/////////////////////////////////
+void Mount::currentSkyPosition(Angle& ra, Angle& dec) const {
+  ra = currentRAAngle();
+  dec = currentDECAngle();
+  #if POINTING_MODEL == 1
+  applyPointingModel(ra, dec, isPierFlipped(), false);
+  #endif
+  #if EPOCH_CONVERSION == 1
+  dateToEpoch(ra, dec);
+  #endif
 }
 
 /////////////////////////////////
@@ -878,20 +1258,20 @@ const DayTime Mount::currentRA() const {
 /////////////////////////////////
 // Get current DEC value.
 const DegreeTime Mount::currentDEC() const {
+  Angle ra, dec;
+  currentSkyPosition(ra, dec);
+  return dec.toDegreeTime();
+}
 
-  float degreePos = 1.0 * _stepperDEC->currentPosition() / _stepsPerDECDegree;
-  //LOGV2(DEBUG_MOUNT_VERBOSE,"CurrentDEC: Steps/deg  : %d", _stepsPerDECDegree);
-  //LOGV2(DEBUG_MOUNT_VERBOSE,"CurrentDEC: DEC Steps  : %d", _stepperDEC->currentPosition());
-  //LOGV2(DEBUG_MOUNT_VERBOSE,"CurrentDEC: POS        : %s", String(degreePos).c_str());
-
-  if (degreePos > 0)
-  {
-    degreePos = -degreePos;
-    //LOGV1(DEBUG_MOUNT_VERBOSE,"CurrentDEC: Greater Zero, flipping.");
-  }
-
-  //LOGV2(DEBUG_MOUNT_VERBOSE,"CurrentDEC: POS      : %s", DegreeTime(degreePos).ToString());
-  return degreePos;
+/////////////////////////////////
+//
+// currentDECAngle
+//
+/////////////////////////////////
+Angle Mount::currentDECAngle() const {
+  // Both sides of the pole are the same DEC, which is 0 at the pole and negative towards the equator.
+  long position = _stepperDEC->currentPosition();
+  return Angle::fromDegrees(-1.0f * abs(position) / _stepsPerDECDegree);
 }
 
 /////////////////////////////////
@@ -908,10 +1288,27 @@ void Mount::syncPosition(int raHour, int raMinute, int raSecond, int decDegree,
 
   float targetRA, targetDEC;
   LOGV7(DEBUG_MOUNT, "Mount: Sync Position to RA: %d:%d:%d and DEC: %d*%d:%d", raHour, raMinute, raSecond, decDegree, decMinute, decSecond);
-  calculateRAandDECSteppers(targetRA, targetDEC);
-  LOGV3(DEBUG_MOUNT, "Mount: Sync Stepper Position is RA: %d and DEC: %d", targetRA, targetDEC);
-  _stepperRA->setCurrentPosition(targetRA);
-  _stepperDEC->setCurrentPosition(targetDEC);
+  #if POINTING_MODEL == 1
+  // The first sync sets the position, later ones tell the model how far off the mount is.
+  if (_positionLost || (_pointingModel.points() == 0)) {
+    _pointingModel.clear();
+  #endif
+    calculateRAandDECSteppers(targetRA, targetDEC);
+    LOGV3(DEBUG_MOUNT, "Mount: Sync Stepper Position is RA: %d and DEC: %d", targetRA, targetDEC);
+    #if DEC_DRIVER_TYPE == TMC2209_UART
+    finishDECAlignment();
+    #endif
+    _stepperRA->setCurrentPosition(targetRA);
+    _stepperDEC->setCurrentPosition(targetDEC);
+  #if POINTING_MODEL == 1
+  }
+  addPointingModelPoint();
+  #endif
+  _positionLost = false;
+  #if POSITION_CHECKPOINT == 1
+  _checkpointEnabled = true;
+  checkpointPosition();
+  #endif
 }
 
 /////////////////////////////////
@@ -921,58 +1318,199 @@ void Mount::syncPosition(int raHour, int raMinute, int raSecond, int decDegree,
 /////////////////////////////////
 // Calculates movement parameters and program steppers to move
 // there. Must call loop() frequently to actually move.
-void Mount::startSlewingToTarget() {
+byte Mount::startSlewingToTarget(byte side) {
+  #if PIER_SIDE_SELECTION == 1
+  if ((side == PIER_SIDE_AUTO) && !_slewingToHome) {
+    side = choosePierSide();
+  }
+  #endif
+
+  // Calculate new RA stepper target (and DEC)
+  float targetRA, targetDEC;
+  byte pierSide = calculateRAandDECSteppers(targetRA, targetDEC, side);
+
+  #if MOUNT_LIMITS == 1
+  // Home is always reachable
+  if (!_slewingToHome) {
+    byte reachable = checkLimits(Angle::fromTime(_targetRA), Angle::fromDegreeTime(_targetDEC), targetRA, targetDEC);
+    if (reachable != TARGET_REACHABLE) {
+      LOGV2(DEBUG_MOUNT, "Mount: Target rejected (%d)", reachable);
+      return reachable;
+    }
+  }
+  #endif
+
   if (isGuiding()) {
     stopGuiding();
   }
-
-  // set Slew microsteps for TMC2209 UART // hier
-  #if RA_DRIVER_TYPE == TMC2209_UART
-  _driverRA->microsteps(SET_MICROSTEPPING);
-  //_driverRA->en_spreadCycle(1);  //only used as audiofeedback for quick debug
+  #if TRAJECTORY_FOLLOWING == 1
+  stopFollowing();
+  #endif
+  _faultStatus = 0;
+  #if POSITION_CHECKPOINT == 1
+  invalidateCheckpoint();
   #endif
 
   // Make sure we're slewing at full speed on a GoTo
   _stepperDEC->setMaxSpeed(_maxDECSpeed);
   _stepperRA->setMaxSpeed(_maxRASpeed);
+  #if MANUAL_SLEW_RAMPS == 1
+  // A manual slew may have left the ramp of a slower preset
+  _stepperDEC->setAcceleration(_maxDECAcceleration);
+  _stepperRA->setAcceleration(_maxRAAcceleration);
+  #endif
 
-  // Calculate new RA stepper target (and DEC)
   _currentDECStepperPosition = _stepperDEC->currentPosition();
   _currentRAStepperPosition = _stepperRA->currentPosition();
-  float targetRA, targetDEC;
-  calculateRAandDECSteppers(targetRA, targetDEC);
+  if (!RAAxis::trackWhileSlewing) {
+    stopSlewing(TRACKING);
+  }
   moveSteppersTo(targetRA, targetDEC);
 
+  // Switch to slew microstepping (TMC2209 UART) before the ISR starts stepping.
+  #if RA_DRIVER_TYPE == TMC2209_UART
+  updateRAMicrostepping(_stepperRA->distanceToGo() != 0);
+  #endif
+
   _mountStatus |= STATUS_SLEWING | STATUS_SLEWING_TO_TARGET;
   _totalDECMove = 1.0f * _stepperDEC->distanceToGo();
   _totalRAMove = 1.0f * _stepperRA->distanceToGo();
-  #if RA_STEPPER_TYPE == STEP_NEMA17  // tracking while slewing causes audible lagging
-  stopSlewing(TRACKING);
-  #endif																					  
+  _targetPierSide = pierSide;
+  return TARGET_REACHABLE;
 }
 
+#if RA_DRIVER_TYPE == TMC2209_UART
 /////////////////////////////////
 //
-// stopGuiding
+// stepsToGrid
 //
 /////////////////////////////////
-void Mount::stopGuiding() {
-  _stepperDEC->stop();
-  while (_stepperDEC->isRunning()) {
-    _stepperDEC->run();
+// Steps from position to the nearest position that is a whole number of ratio steps away from origin.
+// Used before switching a TMC2209 to a coarser microstep mode, so the coarse steps land on the
+// driver's microstep table instead of between its entries.
+static long stepsToGrid(long position, long origin, long ratio)
+{
+  long phase = (position - origin) % ratio;
+  if (phase < 0) {
+    phase += ratio;
+  }
+  if (phase == 0) {
+    return 0;
   }
+  return (2 * phase < ratio) ? -phase : ratio - phase;
+}
 
-  _stepperDEC->setMaxSpeed(_maxDECSpeed);
+/////////////////////////////////
+//
+// updateRAMicrostepping
+//
+/////////////////////////////////
+// Slews run at SET_MICROSTEPPING, tracking, guiding and standing still at TRACKING_MICROSTEPPING.
+// Before the switch to the coarser slew mode, interruptLoop() brings TRK onto the slew microstep grid
+// (tracking gets there by itself within a few steps) and holds the RA slew until loop() has switched the driver.
+void Mount::updateRAMicrostepping(bool slewing)
+{
+  if (!slewing && (_raAlignment != RA_ALIGN_NONE)) {
+    // The slew ended before it started
+    if (_raAlignment == RA_ALIGN_MOVING) {
+      _stepperTRK->moveTo(_stepperTRK->currentPosition());
+      _stepperTRK->setSpeed(0);
+    }
+    _raAlignment = RA_ALIGN_NONE;
+  }
+
+  uint16_t microsteps = slewing ? SET_MICROSTEPPING : TRACKING_MICROSTEPPING;
+  if ((microsteps == _driverRA->microsteps()) || (_raAlignment != RA_ALIGN_NONE)) {
+    return;
+  }
+
+  if (slewing) {
+    long steps = stepsToGrid(_stepperTRK->currentPosition(), -_trackingPhaseOffset, TRACKING_MICROSTEPPING / SET_MICROSTEPPING);
+    if (steps != 0) {
+      LOGV2(DEBUG_MOUNT, "Mount: Aligning RA by %l microsteps before slewing", steps);
+      if ((_mountStatus & STATUS_TRACKING) && (_stepperTRK->speed() != 0)) {
+        _raAlignment = RA_ALIGN_TRACKING;
+      }
+      else {
+        _stepperTRK->moveTo(_stepperTRK->currentPosition() + steps);
+        _stepperTRK->setSpeed(RAAxis::trackingMaxSpeed);
+        _raAlignment = RA_ALIGN_MOVING;
+      }
+      return;
+    }
+  }
+
+  LOGV2(DEBUG_MOUNT, "Mount: RA microstepping is now %d", microsteps);
+  _driverRA->microsteps(microsteps);
+  _driverRA->process();
+}
+#endif
+
+/////////////////////////////////
+//
+// stopGuiding
+//
+/////////////////////////////////
+void Mount::stopGuiding() {
+  bool wasGuidingDEC = (_mountStatus & STATUS_GUIDE_PULSE_DEC) != 0;
+  _stepperDEC->stop();
+  while (_stepperDEC->isRunning()) {
+    _stepperDEC->run();
+  }
+
+  _stepperDEC->setMaxSpeed(_maxDECSpeed);
   _stepperDEC->setAcceleration(_maxDECAcceleration);
-  #if RA_STEPPER_TYPE == STEP_28BYJ48
-  _stepperTRK->setMaxSpeed(10);
-  #else
-  _stepperTRK->setMaxSpeed(500);
-  #endif
+  _stepperTRK->setMaxSpeed(RAAxis::trackingMaxSpeed);
   _stepperTRK->setAcceleration(2500);
-  _stepperTRK->setSpeed(_trackingSpeed);
   _mountStatus &= ~STATUS_GUIDE_PULSE_MASK;
+
+  #if DEC_DRIVER_TYPE == TMC2209_UART
+  if (wasGuidingDEC) {
+    // The pulse ran at DEC_GUIDE_MICROSTEPPING. interruptLoop() finishes it on a whole slew microstep, then loop()
+    // converts the distance moved back to slew microsteps and switches the driver back (finishDECAlignment()).
+    // DEC is held until then, DEC tracking is applied once it is done.
+    long steps = stepsToGrid(_stepperDEC->currentPosition(), _guideStartDECPosition, DEC_GUIDE_MICROSTEPPING / DEC_SLEW_MICROSTEPPING);
+    if (steps != 0) {
+      _stepperDEC->setSpeed(steps > 0 ? _maxDECSpeed : -_maxDECSpeed);
+      _decAlignment = DEC_ALIGN_MOVING;
+    }
+    else {
+      _decAlignment = DEC_ALIGN_SWITCH;
+    }
+  }
+  #endif
+
+  applyTrackingRates();
+}
+
+#if DEC_DRIVER_TYPE == TMC2209_UART
+/////////////////////////////////
+//
+// finishDECAlignment
+//
+/////////////////////////////////
+// A slew started meanwhile has set its target in slew microsteps, setting the position clears it, so it is set again.
+// Set early, DEC is up to a slew microstep off the grid, which the next slew or guide pulse doesn't care about.
+void Mount::finishDECAlignment() {
+  if (_decAlignment == DEC_ALIGN_NONE) {
+    return;
+  }
+  _decAlignment = DEC_ALIGN_SWITCH;    // interruptLoop() leaves DEC alone
+
+  long target = _stepperDEC->targetPosition();
+  bool toTarget = (_mountStatus & STATUS_SLEWING) && !(_mountStatus & (STATUS_SLEWING_MANUAL | STATUS_FOLLOWING));
+  long guidedSteps = (_stepperDEC->currentPosition() - _guideStartDECPosition) / (DEC_GUIDE_MICROSTEPPING / DEC_SLEW_MICROSTEPPING);
+  _stepperDEC->setCurrentPosition(_guideStartDECPosition + guidedSteps);
+  _driverDEC->microsteps(DEC_SLEW_MICROSTEPPING);
+  _driverDEC->process();
+  if (toTarget) {
+    _stepperDEC->moveTo(target);
+  }
+  LOGV2(DEBUG_MOUNT, "Mount: DEC microstepping is now %d", DEC_SLEW_MICROSTEPPING);
+  _decAlignment = DEC_ALIGN_NONE;
+  applyTrackingRates();
 }
+#endif
 
 /////////////////////////////////
 //
@@ -980,15 +1518,18 @@ void Mount::stopGuiding() {
 //
 /////////////////////////////////
 void Mount::guidePulse(byte direction, int duration) {
+  #if TRAJECTORY_FOLLOWING == 1
+  // The trajectory already corrects any drift
+  if (isFollowing()) {
+    return;
+  }
+  #endif
+
   // DEC stepper moves at sidereal rate in both directions
   // RA stepper moves at either 2x sidereal rate or stops.
   // TODO: Do we need to adjust with _trackingSpeedCalibration?
-  float decTrackingSpeed = _stepsPerDECDegree * siderealDegreesInHour / 3600.0f;
-  #if RA_STEPPER_TYPE == STEP_28BYJ48
-  float raTrackingSpeed = _stepsPerRADegree * siderealDegreesInHour / 3600.0f;
-  #else
-  float raTrackingSpeed = ((_stepsPerRADegree / SET_MICROSTEPPING) * TRACKING_MICROSTEPPING) * siderealDegreesInHour / 3600.0f;
-  #endif
+  float decTrackingSpeed = DECAxis::siderealStepsPerSecond(_stepsPerDECDegree);
+  float raTrackingSpeed = RAAxis::siderealStepsPerSecond(_stepsPerRADegree);
 
 
   // TODO: Do we need to track how many steps the steppers took and add them to the GoHome calculation?
@@ -1000,55 +1541,50 @@ void Mount::guidePulse(byte direction, int duration) {
   switch (direction) {
     case NORTH:
     #if DEC_DRIVER_TYPE == TMC2209_UART
-    _driverDEC->microsteps(DEC_GUIDE_MICROSTEPPING);
+    if (_decAlignment != DEC_ALIGN_NONE) {
+      // The last pulse is still being finished, the driver is still at guide microstepping
+      _decAlignment = DEC_ALIGN_NONE;
+    }
+    else if (!(_mountStatus & STATUS_GUIDE_PULSE_DEC)) {
+      _guideStartDECPosition = _stepperDEC->currentPosition();
+      _driverDEC->microsteps(DEC_GUIDE_MICROSTEPPING);
+      _driverDEC->process();
+    }
     #endif
     _stepperDEC->setAcceleration(2500);
-    #if DEC_STEPPER_TYPE == STEP_28BYJ48
-    _stepperDEC->setMaxSpeed(decTrackingSpeed * (1.0 + 0.2));
-    _stepperDEC->setSpeed(decTrackingSpeed * 1.0);
-    #else // NEMA
-    _stepperDEC->setMaxSpeed(decTrackingSpeed * (DEC_PULSE_MULTIPLIER + 0.2));
-    _stepperDEC->setSpeed(decTrackingSpeed * DEC_PULSE_MULTIPLIER);
-    #endif
+    _stepperDEC->setMaxSpeed(decTrackingSpeed * (decGuideRate + 0.2));
+    _stepperDEC->setSpeed(decTrackingSpeed * decGuideRate);
     _mountStatus |= STATUS_GUIDE_PULSE | STATUS_GUIDE_PULSE_DEC;
     break;
 
     case SOUTH:
     #if DEC_DRIVER_TYPE == TMC2209_UART
-    _driverDEC->microsteps(DEC_GUIDE_MICROSTEPPING);
+    if (_decAlignment != DEC_ALIGN_NONE) {
+      _decAlignment = DEC_ALIGN_NONE;
+    }
+    else if (!(_mountStatus & STATUS_GUIDE_PULSE_DEC)) {
+      _guideStartDECPosition = _stepperDEC->currentPosition();
+      _driverDEC->microsteps(DEC_GUIDE_MICROSTEPPING);
+      _driverDEC->process();
+    }
     #endif
     _stepperDEC->setAcceleration(2500);
-    #if DEC_STEPPER_TYPE == STEP_28BYJ48
-    _stepperDEC->setMaxSpeed(decTrackingSpeed * (1.0 + 0.2));
-    _stepperDEC->setSpeed(-decTrackingSpeed * 1.0);
-    #else // NEMA
-    _stepperDEC->setMaxSpeed(decTrackingSpeed * (DEC_PULSE_MULTIPLIER + 0.2));
-    _stepperDEC->setSpeed(-decTrackingSpeed * DEC_PULSE_MULTIPLIER);
-    #endif
+    _stepperDEC->setMaxSpeed(decTrackingSpeed * (decGuideRate + 0.2));
+    _stepperDEC->setSpeed(-decTrackingSpeed * decGuideRate);
     _mountStatus |= STATUS_GUIDE_PULSE | STATUS_GUIDE_PULSE_DEC;
     break;
 
     case WEST:
     
-    #if RA_STEPPER_TYPE == STEP_28BYJ48
-    _stepperTRK->setMaxSpeed(raTrackingSpeed * 2.2 );
-    _stepperTRK->setSpeed(raTrackingSpeed * 2.0);
-    #else  // NEMA
-    _stepperTRK->setMaxSpeed(raTrackingSpeed * (RA_PULSE_MULTIPLIER + 0.2 ));
-    _stepperTRK->setSpeed(raTrackingSpeed * RA_PULSE_MULTIPLIER);
-    #endif
+    _stepperTRK->setMaxSpeed(raTrackingSpeed * (raGuideWestRate + 0.2));
+    _stepperTRK->setSpeed(raTrackingSpeed * raGuideWestRate);
     _mountStatus |= STATUS_GUIDE_PULSE | STATUS_GUIDE_PULSE_RA;
     break;
 
     case EAST:
-    #if RA_STEPPER_TYPE == STEP_28BYJ48
-      _stepperTRK->setMaxSpeed(raTrackingSpeed * 2.2 );
-      _stepperTRK->setSpeed(0);
-    #else // NEMA
-      // Not sure why we don't stop tracking with NEMAs as is customary.....
-      _stepperTRK->setMaxSpeed(raTrackingSpeed * (RA_PULSE_MULTIPLIER + 0.2));
-      _stepperTRK->setSpeed(raTrackingSpeed * (RA_PULSE_MULTIPLIER - 1));
-    #endif
+    // Not sure why we don't stop tracking with NEMAs as is customary.....
+    _stepperTRK->setMaxSpeed(raTrackingSpeed * (raGuideWestRate + 0.2));
+    _stepperTRK->setSpeed(raTrackingSpeed * raGuideEastRate);
     _mountStatus |= STATUS_GUIDE_PULSE | STATUS_GUIDE_PULSE_RA;
     break;
   }
@@ -1120,6 +1656,14 @@ void Mount::setManualSlewMode(bool state) {
     stopSlewing(ALL_DIRECTIONS);
     stopSlewing(TRACKING);
     waitUntilStopped(ALL_DIRECTIONS);
+    #if POSITION_CHECKPOINT == 1
+    invalidateCheckpoint();
+    #endif
+    #if MANUAL_SLEW_RAMPS == 1
+    _manualRASpeed = 0;
+    _manualDECSpeed = 0;
+    _lastManualSlewUpdate = millis();
+    #endif
     _mountStatus |= STATUS_SLEWING | STATUS_SLEWING_MANUAL;
   }
   else {
@@ -1131,6 +1675,9 @@ void Mount::setManualSlewMode(bool state) {
     _stepperDEC->setMaxSpeed(_maxDECSpeed);
     _stepperDEC->setAcceleration(_maxDECAcceleration);
     startSlewing(TRACKING);
+    #if POSITION_CHECKPOINT == 1
+    checkpointPosition();
+    #endif
   }
 }
 
@@ -1140,6 +1687,19 @@ void Mount::setManualSlewMode(bool state) {
 //
 /////////////////////////////////
 void Mount::setSpeed(int which, float speed) {
+  #if MANUAL_SLEW_RAMPS == 1
+  // In manual slew mode loop() ramps the stepper to the new speed
+  if ((_mountStatus & STATUS_SLEWING_MANUAL) && ((which == RA_STEPS) || (which == DEC_STEPS))) {
+    if (which == RA_STEPS) {
+      _manualRASpeed = speed;
+    }
+    else {
+      _manualDECSpeed = speed;
+    }
+    _mountStatus |= STATUS_SLEWING;
+  }
+  else
+  #endif
   if (which == RA_STEPS) {
     _stepperRA->setSpeed(speed);
   }
@@ -1247,17 +1807,31 @@ bool Mount::isRunningALT() const {
 // moveBy
 //
 /////////////////////////////////
+// Take up backlash when reversing.
+static long backlashSteps(long steps, char& lastDirection, int backlash)
+{
+  if (steps == 0) {
+    return 0;
+  }
+  char direction = (steps > 0) ? 1 : -1;
+  if ((lastDirection != 0) && (direction != lastDirection)) {
+    steps += direction * backlash;
+  }
+  lastDirection = direction;
+  return steps;
+}
+
 void Mount::moveBy(int direction, float arcMinutes)
 {
     if (direction == AZIMUTH_STEPS) {
       enableAzAltMotors();
-      int stepsToMove = 2.0f * arcMinutes * AZIMUTH_STEPS_PER_ARC_MINUTE;
-      _stepperAZ->move(stepsToMove);
+      long stepsToMove = 2.0f * arcMinutes * AZIMUTH_STEPS_PER_ARC_MINUTE;
+      _stepperAZ->move(backlashSteps(stepsToMove, _azDirection, AZIMUTH_BACKLASH_STEPS));
     }
     else if (direction == ALTITUDE_STEPS) {
       enableAzAltMotors();
-      int stepsToMove = arcMinutes * ALTITUDE_STEPS_PER_ARC_MINUTE;
-      _stepperALT->move(stepsToMove);
+      long stepsToMove = arcMinutes * ALTITUDE_STEPS_PER_ARC_MINUTE;
+      _stepperALT->move(backlashSteps(stepsToMove, _altDirection, ALTITUDE_BACKLASH_STEPS));
     }
 }
 
@@ -1288,6 +1862,64 @@ void Mount::enableAzAltMotors() {
 
 #endif
 
+#if AZIMUTH_ALTITUDE_MOTORS == 1 && POLAR_ALIGNMENT == 1
+/////////////////////////////////
+//
+// startPolarAlignment
+//
+/////////////////////////////////
+void Mount::startPolarAlignment() {
+  LOGV1(DEBUG_MOUNT, "Mount: Start polar alignment");
+  _polarAlignment.start();
+}
+
+/////////////////////////////////
+//
+// polarAlignmentMeasured
+//
+/////////////////////////////////
+// A measurement taken while the motors still move is of no use, so it is ignored.
+byte Mount::polarAlignmentMeasured(float azError, float altError) {
+  if (_polarAlignment.state() == POLAR_ALIGN_MOVING) {
+    return POLAR_ALIGN_MOVING;
+  }
+  if (_polarAlignment.state() == POLAR_ALIGN_IDLE) {
+    _polarAlignment.start();
+  }
+
+  float azMove, altMove;
+  if (_polarAlignment.measure(azError, altError, azMove, altMove)) {
+    moveBy(AZIMUTH_STEPS, azMove);
+    moveBy(ALTITUDE_STEPS, altMove);
+    if (!_stepperAZ->isRunning() && !_stepperALT->isRunning()) {
+      // Less than a step to move
+      _polarAlignment.moved();
+    }
+  }
+  return _polarAlignment.state();
+}
+
+/////////////////////////////////
+//
+// stopPolarAlignment
+//
+/////////////////////////////////
+void Mount::stopPolarAlignment() {
+  LOGV1(DEBUG_MOUNT, "Mount: Stop polar alignment");
+  _polarAlignment.reset();
+  disableAzAltMotors();
+}
+
+/////////////////////////////////
+//
+// polarAlignment
+//
+/////////////////////////////////
+const PolarAlignment& Mount::polarAlignment() const {
+  return _polarAlignment;
+}
+#endif
+
 /////////////////////////////////
 //
 // mountStatus
@@ -1344,7 +1976,10 @@ String Mount::mountStatusString() {
 /////////////////////////////////
 String Mount::getStatusString() {
   String status;
-  if (_mountStatus == STATUS_PARKED) {
+  if (hasFault()) {
+    status = "Fault,";
+  }
+  else if (_mountStatus == STATUS_PARKED) {
     status = "Parked,";
   }
   else if (_mountStatus & STATUS_PARKING) {
@@ -1356,6 +1991,11 @@ String Mount::getStatusString() {
   else if (isFindingHome()) {
     status = "Homing,";
   }
+  #if TRAJECTORY_FOLLOWING == 1
+  else if (isFollowing()) {
+    status = "Following,";
+  }
+  #endif
   else if (slewStatus() & SLEW_MASK_ANY) {
     if (_mountStatus & STATUS_SLEWING_TO_TARGET) {
       status = "SlewToTarget,";
@@ -1396,6 +2036,17 @@ String Mount::getStatusString() {
 
   status += RAString(COMPACT_STRING | CURRENT_STRING) + ",";
   status += DECString(COMPACT_STRING | CURRENT_STRING) + ",";
+  if (_positionLost) {
+    status += "PosLost,";
+  }
+  #if MERIDIAN_FLIP == 1
+  if (_flipNeeded) {
+    status += "FlipNeeded,";
+  }
+  #endif
+  if (_faultStatus & FAULT_LIMIT) {
+    status += "Limit,";
+  }
 
   return status;
 }
@@ -1415,7 +2066,7 @@ byte Mount::slewStatus() const {
     return NOT_SLEWING;
   }
   byte slewState = _stepperRA->isRunning() ? SLEWING_RA : NOT_SLEWING;
-  slewState |= _stepperDEC->isRunning() ? SLEWING_DEC : NOT_SLEWING;
+  slewState |= isDECStepperSlewing() ? SLEWING_DEC : NOT_SLEWING;
 
   slewState |= (_mountStatus & STATUS_TRACKING) ? SLEWING_TRACKING : NOT_SLEWING;
   return slewState;
@@ -1507,6 +2158,24 @@ bool Mount::isFindingHome() const {
   return _mountStatus & STATUS_FINDING_HOME;
 }
 
+/////////////////////////////////
+//
+// hasFault
+//
+/////////////////////////////////
+bool Mount::hasFault() const {
+  return _faultStatus != 0;
+}
+
+/////////////////////////////////
+//
+// isPositionLost
+//
+/////////////////////////////////
+bool Mount::isPositionLost() const {
+  return _positionLost;
+}
+
 /////////////////////////////////
 //
 // startSlewing
@@ -1522,23 +2191,23 @@ void Mount::startSlewing(int direction) {
     }
 
     if (direction & TRACKING) {
-      _stepperTRK->setSpeed(_trackingSpeed);
-
-      
       // Turn on tracking
       _mountStatus |= STATUS_TRACKING;
+      applyTrackingRates();
 
     }
     else {
       int sign = NORTHERN_HEMISPHERE ? 1 : -1;
 
+      #if TRAJECTORY_FOLLOWING == 1
+      stopFollowing();
+      #endif
+      #if POSITION_CHECKPOINT == 1
+      invalidateCheckpoint();
+      #endif
+
       // Set move rate to last commanded slew rate
       setSlewRate(_moveRate);
-      #if RA_DRIVER_TYPE == TMC2209_UART
-      _driverRA->microsteps(SET_MICROSTEPPING);
-      //_driverRA->en_spreadCycle(1);  //only used as audiofeedback for quick debug
-      //hier
-      #endif
       if (direction & NORTH) {
         _stepperDEC->moveTo(sign * 300000);
         _mountStatus |= STATUS_SLEWING;
@@ -1555,6 +2224,9 @@ void Mount::startSlewing(int direction) {
         _stepperRA->moveTo(sign * 300000);
         _mountStatus |= STATUS_SLEWING;
       }
+      #if RA_DRIVER_TYPE == TMC2209_UART
+      updateRAMicrostepping(_stepperRA->distanceToGo() != 0);
+      #endif
     }
   }
 }
@@ -1566,17 +2238,44 @@ void Mount::startSlewing(int direction) {
 // Stop manual slewing in one of two directions or Tracking. NS is the same. EW is the same
 /////////////////////////////////
 void Mount::stopSlewing(int direction) {
+  #if TRAJECTORY_FOLLOWING == 1
+  if (isFollowing()) {
+    stopFollowing();
+  }
+  #endif
+
   if (direction & TRACKING) {
     // Turn off tracking
     _mountStatus &= ~STATUS_TRACKING;
 
     _stepperTRK->stop();
+    if (!isDECStepperSlewing()) {
+      // Stop DEC following its tracking rate. Nothing steps it outside slews and tracking, so it would never get there by itself.
+      _stepperDEC->setSpeed(0);
+      _stepperDEC->moveTo(_stepperDEC->currentPosition());
+    }
   }
 
+  #if MANUAL_SLEW_RAMPS == 1
+  // Free slews stop with the deceleration of their preset, manual slew mode ramps down in loop()
+  bool freeSlew = (_mountStatus & STATUS_SLEWING_TO_TARGET) == 0;
+  #endif
   if ((direction & (NORTH | SOUTH)) != 0) {
+    #if MANUAL_SLEW_RAMPS == 1
+    _manualDECSpeed = 0;
+    if (freeSlew) {
+      _stepperDEC->setAcceleration(_slewDeceleration[_moveRate - 1] * _maxDECAcceleration);
+    }
+    #endif
     _stepperDEC->stop();
   }
   if ((direction & (WEST | EAST)) != 0) {
+    #if MANUAL_SLEW_RAMPS == 1
+    _manualRASpeed = 0;
+    if (freeSlew) {
+      _stepperRA->setAcceleration(_slewDeceleration[_moveRate - 1] * _maxRAAcceleration);
+    }
+    #endif
     _stepperRA->stop();    
   }
 }
@@ -1589,7 +2288,7 @@ void Mount::stopSlewing(int direction) {
 // Block until the RA and DEC motors are stopped
 void Mount::waitUntilStopped(byte direction) {
   while (((direction & (EAST | WEST)) && _stepperRA->isRunning())
-         || ((direction & (NORTH | SOUTH)) && _stepperDEC->isRunning())
+         || ((direction & (NORTH | SOUTH)) && isDECStepperSlewing())
          || ((direction & TRACKING) && (((_mountStatus & STATUS_TRACKING) == 0) && _stepperTRK->isRunning()))
          ) {
     loop();
@@ -1629,6 +2328,14 @@ void Mount::delay(int ms) {
   }
 }
 
+#if RA_DRIVER_TYPE == TMC2209_UART && DEC_DRIVER_TYPE == TMC2209_UART && COLLISION_DETECTION == 1
+// StallGuard reads are meaningless while the motor is standing still or only just starting a ramp.
+// The drivers are kept in StealthChop (see configureRAdriver()), so above that StallGuard covers the rest of the slew.
+static inline bool isStallGuardReliable(AccelStepper* stepper) {
+  return fabs(stepper->speed()) > stepper->maxSpeed() / 4;
+}
+#endif
+
 /////////////////////////////////
 //
 // interruptLoop()
@@ -1637,8 +2344,67 @@ void Mount::delay(int ms) {
 /////////////////////////////////
 void Mount::interruptLoop()
 {
+  #if RA_DRIVER_TYPE == TMC2209_UART && DEC_DRIVER_TYPE == TMC2209_UART && USE_AUTOHOME == 1
+  if (_stallArmed && (digitalRead((_homingAxis == RA_STEPS) ? RA_DIAG_PIN : DEC_DIAG_PIN) == HIGH)) {
+    stallDetected(_homingAxis);
+  }
+  #endif
+
+  #if RA_DRIVER_TYPE == TMC2209_UART && DEC_DRIVER_TYPE == TMC2209_UART && COLLISION_DETECTION == 1
+  if ((_mountStatus & STATUS_SLEWING_TO_TARGET) && (_faultStatus == 0)) {
+    byte stalled = 0;
+    if (isStallGuardReliable(_stepperRA) && (digitalRead(RA_DIAG_PIN) == HIGH)) {
+      stalled |= FAULT_STALL_RA;
+    }
+    if (isStallGuardReliable(_stepperDEC) && (digitalRead(DEC_DIAG_PIN) == HIGH)) {
+      stalled |= FAULT_STALL_DEC;
+    }
+    if (stalled != 0) {
+      // Something is blocking the mount. Ramp both axes down, the steps since the stall are not to be trusted.
+      _faultStatus = stalled;
+      _positionLost = true;
+      _stepperRA->stop();
+      _stepperDEC->stop();
+    }
+  }
+  #endif
+
+  // Whether RA, TRK and DEC may be stepped below, they are held while being moved onto a coarser microstep grid.
+  bool raFree = true;
+  bool trkFree = true;
+  bool decFree = true;
+  #if RA_DRIVER_TYPE == TMC2209_UART
+  if ((_raAlignment == RA_ALIGN_MOVING) || (_raAlignment == RA_ALIGN_TRACKING)) {
+    // Tracking moves TRK onto the grid by itself, one microstep at a time
+    if ((_raAlignment == RA_ALIGN_MOVING) && !(_mountStatus & STATUS_GUIDE_PULSE_RA)) {
+      _stepperTRK->runSpeedToPosition();
+    }
+    if (((_stepperTRK->currentPosition() + _trackingPhaseOffset) % (TRACKING_MICROSTEPPING / SET_MICROSTEPPING)) == 0) {
+      if (_raAlignment == RA_ALIGN_MOVING) {
+        _stepperTRK->setSpeed(0);
+      }
+      _raAlignment = RA_ALIGN_SWITCH;
+    }
+  }
+  raFree = (_raAlignment == RA_ALIGN_NONE);
+  trkFree = (_raAlignment == RA_ALIGN_NONE) || (_raAlignment == RA_ALIGN_TRACKING);
+  #endif
+  #if DEC_DRIVER_TYPE == TMC2209_UART
+  if (_decAlignment == DEC_ALIGN_MOVING) {
+    // A slew started meanwhile may have changed the target and speed, any grid position will do
+    if ((((_stepperDEC->currentPosition() - _guideStartDECPosition) % (DEC_GUIDE_MICROSTEPPING / DEC_SLEW_MICROSTEPPING)) == 0)
+        || (_stepperDEC->speed() == 0)) {
+      _decAlignment = DEC_ALIGN_SWITCH;
+    }
+    else {
+      _stepperDEC->runSpeed();
+    }
+  }
+  decFree = (_decAlignment == DEC_ALIGN_NONE);
+  #endif
+
   if (_mountStatus & STATUS_GUIDE_PULSE) {
-    if (_mountStatus & STATUS_GUIDE_PULSE_RA) {
+    if ((_mountStatus & STATUS_GUIDE_PULSE_RA) && trkFree) {
       _stepperTRK->runSpeed();    
     }
     if (_mountStatus & STATUS_GUIDE_PULSE_DEC) {
@@ -1648,19 +2414,32 @@ void Mount::interruptLoop()
   }
 
   if (_mountStatus & STATUS_TRACKING ) {
-    //if ~(_mountStatus & STATUS_SLEWING) {
+    // TRK stands still on the grid while the RA driver is switched
+    if (trkFree) {
       _stepperTRK->runSpeed();
-    //}
+    }
+    if (decFree && ((_mountStatus & STATUS_SLEWING) == 0)) {
+      // Runs at the DEC tracking rate, which is usually zero
+      _stepperDEC->runSpeed();
+    }
   }
 
   if (_mountStatus & STATUS_SLEWING) {
-    if (_mountStatus & STATUS_SLEWING_MANUAL) {
-      _stepperDEC->runSpeed();
-      _stepperRA->runSpeed();
+    if (_mountStatus & (STATUS_SLEWING_MANUAL | STATUS_FOLLOWING)) {
+      if (decFree) {
+        _stepperDEC->runSpeed();
+      }
+      if (raFree) {
+        _stepperRA->runSpeed();
+      }
     }
     else {
-      _stepperDEC->run();
-      _stepperRA->run();
+      if (decFree) {
+        _stepperDEC->run();
+      }
+      if (raFree) {
+        _stepperRA->run();
+      }
     }
   }
 
@@ -1681,6 +2460,8 @@ void Mount::loop() {
   unsigned long now = millis();
   bool raStillRunning = false;
   bool decStillRunning = false;
+
+  updateSiderealClock();
   
   // Since some of the boards cannot process timer interrupts at the required 
   // speed (or at all), we'll just stick to deterministic calls here.
@@ -1688,6 +2469,31 @@ void Mount::loop() {
   interruptLoop();
   #endif
 
+  // Clock out any TMC2209 register writes queued since the last pass.
+  #if RA_DRIVER_TYPE == TMC2209_UART
+  if (_raAlignment == RA_ALIGN_SWITCH) {
+    // TRK is on the slew microstep grid, RA can slew once the driver has its new mode
+    _driverRA->microsteps(SET_MICROSTEPPING);
+    _driverRA->process();
+    if (!_driverRA->isBusy()) {
+      LOGV2(DEBUG_MOUNT, "Mount: RA microstepping is now %d", SET_MICROSTEPPING);
+      _raAlignment = RA_ALIGN_NONE;
+    }
+  }
+  _driverRA->process();
+  #endif
+  #if DEC_DRIVER_TYPE == TMC2209_UART
+  if (_decAlignment == DEC_ALIGN_SWITCH) {
+    finishDECAlignment();
+  }
+  _driverDEC->process();
+  #endif
+
+  // Read the next gyro sample, if the gyro is started and one is due.
+  #if GYRO_LEVEL == 1
+  Gyro::process();
+  #endif
+
   #if DEBUG_LEVEL&DEBUG_MOUNT 
   if (now - _lastMountPrint > 2000) {
     Serial.println(getStatusString());
@@ -1701,38 +2507,53 @@ void Mount::loop() {
     // One of the motors was running last time through the loop, but not anymore, so shutdown the outputs.
     disableAzAltMotors();
     _azAltWasRunning = false;
+    #if POLAR_ALIGNMENT == 1
+    _polarAlignment.moved();
+    #endif
   }
   if (_stepperALT->isRunning() || _stepperAZ->isRunning() )
   {
      _azAltWasRunning = true;
   }
+  #if GYRO_LEVEL == 1 && AUTO_LEVEL == 1
+  if (_levelState == LEVEL_RUNNING) {
+    processLevelling();
+  }
+  #endif
   #endif
 
   #if RA_DRIVER_TYPE == TMC2209_UART && DEC_DRIVER_TYPE == TMC2209_UART && USE_AUTOHOME == 1
   if (isFindingHome()) {
-    if (digitalRead(DEC_DIAG_PIN) == HIGH) {
-      finishFindingHomeDEC();
-      return;
-    }
-    if (digitalRead(RA_DIAG_PIN) == HIGH) {
-      finishFindingHomeRA();
-      return;
-    }    
-    //return;
+    processHoming();
+    return;
   }
   #endif
   
   if (isGuiding()) {
     if (millis() > _guideEndTime) {
       stopGuiding();
-	  #if DEC_DRIVER_TYPE == TMC2209_UART
-      _driverDEC->microsteps(DEC_SLEW_MICROSTEPPING);
-    #endif					
     }
     return;
   }
 
-  if (_stepperDEC->isRunning()) {
+  #if TRAJECTORY_FOLLOWING == 1
+  if (isFollowing()) {
+    processTrajectory();
+    return;
+  }
+  #endif
+
+  #if MANUAL_SLEW_RAMPS == 1
+  if (_mountStatus & STATUS_SLEWING_MANUAL) {
+    processManualSlew();
+    // A ramp that is just starting has no speed yet, but the slew is on
+    if ((_manualRASpeed != 0) || (_manualDECSpeed != 0)) {
+      raStillRunning = true;
+    }
+  }
+  #endif
+
+  if (isDECStepperSlewing()) {
     decStillRunning = true;
   }
 
@@ -1748,6 +2569,7 @@ void Mount::loop() {
     if (_mountStatus & STATUS_SLEWING_MANUAL) {
       if (_stepperWasRunning) {
         _mountStatus &= ~(STATUS_SLEWING);
+        applyTrackingRates();
       }
     }    
     
@@ -1756,6 +2578,13 @@ void Mount::loop() {
 
       if (_stepperWasRunning) {
         LOGV1(DEBUG_MOUNT,"Mount::Loop: Reached target.");
+        if (hasFault()) {
+          // Stopped early by a stall, so we're not where we wanted to be. Don't set home or park here.
+          LOGV2(DEBUG_MOUNT,"Mount::Loop:   Slew was stopped by a stall (%x), position is lost.", _faultStatus);
+          _mountStatus &= ~STATUS_PARKING;
+          _slewingToHome = false;
+          _correctForBacklash = false;
+        }
         // Mount is at Target!
         // If we we're parking, we just reached home. Clear the flag, reset the motors and stop tracking.
         if (isParking()) {
@@ -1767,7 +2596,7 @@ void Mount::loop() {
         _currentDECStepperPosition = _stepperDEC->currentPosition();
         _currentRAStepperPosition = _stepperRA->currentPosition();
         #if RA_DRIVER_TYPE == TMC2209_UART
-        _driverRA->microsteps(TRACKING_MICROSTEPPING);
+        updateRAMicrostepping(false);
         if (!isParking()) {
 		      startSlewing(TRACKING);					   
         }
@@ -1801,6 +2630,22 @@ void Mount::loop() {
           _slewingToHome = false;
         }
         _totalDECMove = _totalRAMove = 0;
+        #if POSITION_CHECKPOINT == 1
+        checkpointPosition();
+        #endif
+
+        // The DEC stepper can track again, at the rates for the new position
+        #if REFRACTION_TRACKING == 1
+        if (_refractionTracking) {
+          updateRefractionRates();
+        }
+        #endif
+        applyTrackingRates();
+
+        // A goto can end with the RA ring past the flip limit
+        #if MERIDIAN_FLIP == 1
+        checkMeridianFlip();
+        #endif
 
         // Make sure we do one last update when the steppers have stopped.
         displayStepperPosition();
@@ -1810,6 +2655,38 @@ void Mount::loop() {
       }
     }
 
+    // Write configuration changes while nothing is moving.
+    EPROMStore::Storage()->process();
+
+    #if POSITION_CHECKPOINT == 1
+    if (isSlewingTRK() && (now - _lastCheckpoint > POSITION_CHECKPOINT_INTERVAL * 1000UL)) {
+      checkpointPosition();
+    }
+    #endif
+
+    #if REFRACTION_TRACKING == 1
+    if (_refractionTracking && isSlewingTRK() && (now - _lastRefractionUpdate > REFRACTION_UPDATE_INTERVAL * 1000UL)) {
+      updateRefractionRates();
+    }
+    #endif
+
+    #if MERIDIAN_FLIP == 1
+    if (isSlewingTRK() && (now - _lastFlipCheck > MERIDIAN_FLIP_CHECK_INTERVAL * 1000UL)) {
+      checkMeridianFlip();
+    }
+    #endif
+
+    #if MOUNT_LIMITS == 1
+    if (isSlewingTRK() && ((_mountStatus & STATUS_SLEWING) == 0) && (now - _lastLimitCheck > LIMIT_CHECK_INTERVAL * 1000UL)) {
+      _lastLimitCheck = now;
+      if (checkLimits(currentRAAngle(), currentDECAngle(), _stepperRA->currentPosition(), _stepperDEC->currentPosition()) != TARGET_REACHABLE) {
+        LOGV1(DEBUG_MOUNT, "Mount::Loop: Tracking reached a limit, stop tracking.");
+        stopSlewing(TRACKING);
+        _faultStatus |= FAULT_LIMIT;
+      }
+    }
+    #endif
+
     if ((_bootComplete) && (now - _lastTrackingPrint > 200)) {
       _lcdMenu->printAt(14,0, ' ');
       _lcdMenu->printAt(15,0, isSlewingTRK() ? 'T' : '.');
@@ -1840,47 +2717,172 @@ void Mount::setHome(bool clearZeroPos) {
   //LOGV2(DEBUG_MOUNT_VERBOSE,"Mount::setHomePre: currentRA is %s", currentRA().ToString());
   //LOGV2(DEBUG_MOUNT_VERBOSE,"Mount::setHomePre: zeroPos is %s", _zeroPosRA.ToString());
   //LOGV2(DEBUG_MOUNT_VERBOSE,"Mount::setHomePre: targetRA is %s", targetRA().ToString());
-  _zeroPosRA = clearZeroPos ? DayTime(PolarisRAHour, PolarisRAMinute, PolarisRASecond) :currentRA();
+  _zeroPosRA = clearZeroPos ? Angle::fromTime(DayTime(PolarisRAHour, PolarisRAMinute, PolarisRASecond)) : currentRAAngle();
 
+  #if RA_DRIVER_TYPE == TMC2209_UART
+  // Remember where the motor is on the microstep grid, the TRK position is about to be reset.
+  _trackingPhaseOffset = (_trackingPhaseOffset + _stepperTRK->currentPosition()) % (TRACKING_MICROSTEPPING / SET_MICROSTEPPING);
+  #endif
+  #if DEC_DRIVER_TYPE == TMC2209_UART
+  finishDECAlignment();
+  #endif
   _stepperRA->setCurrentPosition(0);
   _stepperDEC->setCurrentPosition(0);
   _stepperTRK->setCurrentPosition(0);
+  _positionLost = false;
+  #if POINTING_MODEL == 1
+  // The syncs were relative to the old zero position.
+  _pointingModel.clear();
+  #endif
 
   _targetRA = currentRA();
+  #if POSITION_CHECKPOINT == 1
+  _checkpointEnabled = true;
+  checkpointPosition();
+  #endif
 
   //LOGV2(DEBUG_MOUNT_VERBOSE,"Mount::setHomePost: currentRA is %s", currentRA().ToString());
   //LOGV2(DEBUG_MOUNT_VERBOSE,"Mount::setHomePost: zeroPos is %s", _zeroPosRA.ToString());
   //LOGV2(DEBUG_MOUNT_VERBOSE,"Mount::setHomePost: targetRA is %s", targetRA().ToString());
 }
 
+#if POSITION_CHECKPOINT == 1
 /////////////////////////////////
 //
-// setTargetToHome
+// checkpointPosition
 //
-// Set RA and DEC to the home position
 /////////////////////////////////
-void Mount::setTargetToHome() {
-  
-  float trackedSeconds = _stepperTRK->currentPosition() / _trackingSpeed; // steps/steps/s
-  
-  LOGV2(DEBUG_MOUNT,"Mount::setTargetToHome() called with %fs elapsed tracking", trackedSeconds);
+void Mount::checkpointPosition() {
+  if (!_checkpointEnabled) {
+    return;
+  }
 
-  // In order for RA coordinates to work correctly, we need to
-  // offset HATime by elapsed time since last HA set and also
-  // adjust RA by the elapsed time and set it to zero.
-  //LOGV2(DEBUG_MOUNT_VERBOSE,"Mount::setTargetToHomePre:  currentRA is %s", currentRA().ToString());
-  //LOGV2(DEBUG_MOUNT_VERBOSE,"Mount::setTargetToHomePre:  ZeroPosRA is %s", _zeroPosRA.ToString());
+  _lastCheckpoint = millis();
+  if (_positionLost || isSlewingRAorDEC()) {
+    invalidateCheckpoint();
+    return;
+  }
+
+  PositionCheckpoint checkpoint;
+  checkpoint.marker = CHECKPOINT_MARKER;
+  checkpoint.state = CHECKPOINT_VALID | (isSlewingTRK() ? CHECKPOINT_TRACKING : 0);
+  checkpoint.raPosition = _stepperRA->currentPosition();
+  checkpoint.decPosition = _stepperDEC->currentPosition();
+  checkpoint.trkPosition = _stepperTRK->currentPosition();
+  checkpoint.zeroPosRA = _zeroPosRA.raw();
+  checkpoint.lst = currentLST().raw();
+
+  LOGV4(DEBUG_MOUNT, "Mount: Checkpoint RA: %l, DEC: %l, TRK: %l", checkpoint.raPosition, checkpoint.decPosition, checkpoint.trkPosition);
+  _checkpointJournal->append(&checkpoint);
+  _checkpointValid = true;
+}
+
+/////////////////////////////////
+//
+// invalidateCheckpoint
+//
+/////////////////////////////////
+void Mount::invalidateCheckpoint() {
+  // Whatever was saved before is out of date once the mount moves.
+  _checkpointEnabled = true;
+  if (_checkpointValid) {
+    PositionCheckpoint checkpoint;
+    memset(&checkpoint, 0, sizeof(checkpoint));
+    _checkpointJournal->append(&checkpoint);
+    _checkpointValid = false;
+  }
+}
+
+// Get the newest checkpoint, if it is one this firmware wrote and it is still valid.
+static bool readCheckpoint(EPROMJournal* journal, PositionCheckpoint& checkpoint) {
+  return journal->read(&checkpoint) && (checkpoint.marker == CHECKPOINT_MARKER) && (checkpoint.state & CHECKPOINT_VALID);
+}
+
+/////////////////////////////////
+//
+// hasPositionCheckpoint
+//
+/////////////////////////////////
+bool Mount::hasPositionCheckpoint() {
+  PositionCheckpoint checkpoint;
+  return readCheckpoint(_checkpointJournal, checkpoint);
+}
+
+/////////////////////////////////
+//
+// resumeFromCheckpoint
+//
+/////////////////////////////////
+bool Mount::resumeFromCheckpoint() {
+  _checkpointEnabled = true;
+  PositionCheckpoint checkpoint;
+  if (!readCheckpoint(_checkpointJournal, checkpoint)) {
+    LOGV1(DEBUG_MOUNT, "Mount: No position checkpoint to resume from.");
+    return false;
+  }
+
+  byte state = checkpoint.state;
+
+  // Setting the TRK position resets its speed, so tracking is restarted below.
+  stopSlewing(TRACKING);
+  #if DEC_DRIVER_TYPE == TMC2209_UART
+  finishDECAlignment();
+  #endif
+  _stepperRA->setCurrentPosition(checkpoint.raPosition);
+  _stepperDEC->setCurrentPosition(checkpoint.decPosition);
+  _stepperTRK->setCurrentPosition(checkpoint.trkPosition);
+  _currentRAStepperPosition = _stepperRA->currentPosition();
+  _currentDECStepperPosition = _stepperDEC->currentPosition();
+  setSiderealTime(Angle::fromRaw(checkpoint.lst));
+  _zeroPosRA = Angle::fromRaw(checkpoint.zeroPosRA);
+  _targetRA = currentRA();
+  _targetDEC = currentDEC();
+  _checkpointValid = true;
+  _lastCheckpoint = millis();
+
+  LOGV5(DEBUG_MOUNT, "Mount: Resumed at RA %l, DEC %l, LST %s, %s", _currentRAStepperPosition, _currentDECStepperPosition, LST().ToString(), (state & CHECKPOINT_TRACKING) ? "tracking" : "not tracking");
+  if (state & CHECKPOINT_TRACKING) {
+    startSlewing(TRACKING);
+  }
+  return true;
+}
+
+/////////////////////////////////
+//
+// discardCheckpoint
+//
+/////////////////////////////////
+void Mount::discardCheckpoint() {
+  _checkpointValid = true;
+  invalidateCheckpoint();
+}
+#endif
+
+/////////////////////////////////
+//
+// setTargetToHome
+//
+// Set RA and DEC to the home position
+/////////////////////////////////
+void Mount::setTargetToHome() {
+  
+  float trackedSeconds = _stepperTRK->currentPosition() / _trackingSpeed; // steps/steps/s
+  
+  LOGV2(DEBUG_MOUNT,"Mount::setTargetToHome() called with %fs elapsed tracking", trackedSeconds);
+
+  // In order for RA coordinates to work correctly, we need to
+  // move the RA zero point to the current LST and also
+  // adjust RA by the elapsed time and set it to zero.
+  //LOGV2(DEBUG_MOUNT_VERBOSE,"Mount::setTargetToHomePre:  currentRA is %s", currentRA().ToString());
+  //LOGV2(DEBUG_MOUNT_VERBOSE,"Mount::setTargetToHomePre:  ZeroPosRA is %s", _zeroPosRA.ToString());
   //LOGV3(DEBUG_MOUNT_VERBOSE,"Mount::setTargetToHomePre:  TrackedSeconds is %f, TRK Stepper: %l", trackedSeconds, _stepperTRK->currentPosition());
-  //LOGV2(DEBUG_MOUNT_VERBOSE,"Mount::setTargetToHomePre:  LST is %s", _LST.ToString());
-  DayTime lst(_LST);
-  lst.addSeconds(trackedSeconds);
-  setLST(lst);
-  _targetRA = _zeroPosRA;
-  _targetRA.addSeconds(trackedSeconds);
+  //LOGV2(DEBUG_MOUNT_VERBOSE,"Mount::setTargetToHomePre:  LST is %s", LST().ToString());
+  setLST(LST());
+  _targetRA = (_zeroPosRA + Angle::fromHours(trackedSeconds / 3600.0f)).toDayTime();
 
   //LOGV2(DEBUG_MOUNT_VERBOSE,"Mount::setTargetToHomePost:  currentRA is %s", currentRA().ToString());
   //LOGV2(DEBUG_MOUNT_VERBOSE,"Mount::setTargetToHomePost: ZeroPosRA is %s", _zeroPosRA.ToString());
-  //LOGV2(DEBUG_MOUNT_VERBOSE,"Mount::setTargetToHomePost: LST is %s", _LST.ToString());
+  //LOGV2(DEBUG_MOUNT_VERBOSE,"Mount::setTargetToHomePost: LST is %s", LST().ToString());
   //LOGV2(DEBUG_MOUNT_VERBOSE,"Mount::setTargetToHomePost: TargetRA is %s", _targetRA.ToString());
 
   // Set DEC to pole
@@ -1893,118 +2895,1007 @@ void Mount::setTargetToHome() {
 
 /////////////////////////////////
 //
-// getSpeed
+// getSpeed
+//
+// Get the current speed of the stepper. NORTH, WEST, TRACKING
+/////////////////////////////////
+float Mount::getSpeed(int direction) {
+  if (direction & TRACKING) {
+    return _trackingSpeed;
+  }
+  if (direction & (NORTH | SOUTH)) {
+    return _stepperDEC->speed();
+  }
+  if (direction & (EAST | WEST)) {
+    return _stepperRA->speed();
+  }
+  return 0;
+}
+
+
+// Wrap hours to the [-12 to +12] range
+static float wrapHours(float hours) {
+  hours = fmod(hours + 12.0f, 24.0f);
+  return (hours < 0 ? hours + 24.0f : hours) - 12.0f;
+}
+
+/////////////////////////////////
+//
+// calculateRAandDECSteppers
+//
+// This code tells the steppers to what location to move to, given the select right ascension and declination
+/////////////////////////////////
+byte Mount::calculateRAandDECSteppers(float& targetRA, float& targetDEC, byte side) {
+  //LOGV3(DEBUG_MOUNT_VERBOSE,"Mount::CalcSteppersPre: Current: RA: %s, DEC: %s", currentRA().ToString(), currentDEC().ToString());
+  //LOGV3(DEBUG_MOUNT_VERBOSE,"Mount::CalcSteppersPre: Target : RA: %s, DEC: %s", _targetRA.ToString(), _targetDEC.ToString());
+  //LOGV2(DEBUG_MOUNT_VERBOSE,"Mount::CalcSteppersPre: ZeroRA : %s", _zeroPosRA.ToString());
+  //LOGV4(DEBUG_MOUNT_VERBOSE,"Mount::CalcSteppersPre: Stepper: RA: %l, DEC: %l, TRK: %l", _stepperRA->currentPosition(), _stepperDEC->currentPosition(), _stepperTRK->currentPosition());
+  // Home is a stepper position, not a place in the sky
+  return calculateSteppers(Angle::fromTime(_targetRA), Angle::fromDegreeTime(_targetDEC), !_slewingToHome, side, targetRA, targetDEC);
+}
+
+/////////////////////////////////
+//
+// calculateSteppers
+//
+/////////////////////////////////
+// Stepper positions for the given RA and DEC (internal DEC). A sky position is converted from the mount's epoch
+// and corrected by the pointing model. Returns the pier side used.
+byte Mount::calculateSteppers(Angle raTarget, Angle decTarget, bool skyPosition, byte side, float& targetRA, float& targetDEC) {
+  #if EPOCH_CONVERSION == 1
+  if (skyPosition) {
+    epochToDate(raTarget, decTarget);
+  }
+  #endif
+
+  // Tracking has turned the RA ring too, so the side depends on where the ring ends up, not the RA stepper.
+  float tracked = trackedHours();
+
+  // We can move 6 hours in either direction. Outside of that we need to flip directions.
+  if (side == PIER_SIDE_AUTO) {
+    side = (fabs(wrapHours(stepperHours(raTarget) - tracked)) > 6.0f) ? PIER_SIDE_FLIPPED : PIER_SIDE_NORMAL;
+  }
+
+  #if POINTING_MODEL == 1
+  if (skyPosition) {
+    // Some terms change sign on the other side of the pier
+    applyPointingModel(raTarget, decTarget, side == PIER_SIDE_FLIPPED, true);
+  }
+  #endif
+
+  float ringHours = wrapHours(stepperHours(raTarget) - tracked);
+
+  // How many steps moves the RA ring one sidereal hour along. One sidereal hour moves just shy of 15 degrees
+  float stepsPerSiderealHour = RAAxis::stepsPerSiderealHour(_stepsPerRADegree);
+
+
+  // Where do we want to move DEC to?
+  // the variable targetDEC 0deg for the celestial pole (90deg), and goes negative only.
+  float moveDEC = -decTarget.signedDegrees() * _stepsPerDECDegree;
+
+  //LOGV3(DEBUG_MOUNT_VERBOSE,"Mount::CalcSteppersIn: RA Steps/deg: %d   Steps/srhour: %f", _stepsPerRADegree, stepsPerSiderealHour);
+  //LOGV3(DEBUG_MOUNT_VERBOSE,"Mount::CalcSteppersIn: Target ring pos RA: %f, DEC: %f", ringHours, moveDEC);
+
+  if (side == PIER_SIDE_FLIPPED) {
+    //LOGV2(DEBUG_MOUNT_VERBOSE,"Mount::CalcSteppersIn: RA is past limit: %f", ringHours);
+
+    // ... turn both RA and DEC axis around
+    ringHours += (ringHours > 0) ? -12.0f : 12.0f;
+    moveDEC = -moveDEC;
+    //LOGV3(DEBUG_MOUNT_VERBOSE,"Mount::CalcSteppersIn: Adjusted Target ring pos RA: %f, DEC: %f", ringHours, moveDEC);
+  }
+
+  // Where do we want to move RA to? The TRK stepper takes care of the tracked part.
+  float moveRA = (ringHours + tracked) * stepsPerSiderealHour;
+
+  LOGV3(DEBUG_MOUNT,"Mount::CalcSteppersPost: Target Steps RA: %f, DEC: %f", -moveRA, moveDEC);
+  //    float targetRA = clamp(-moveRA, -RAStepperLimit, RAStepperLimit);
+  //    float targetDEC = clamp(moveDEC, DECStepperUpLimit, DECStepperDownLimit);
+  targetRA = -moveRA;
+  targetDEC = moveDEC;
+
+  // Can we get there without physical issues? (not doing anything with this yet)
+  //  isUnreachable = ((targetRA != -moveRA) || (targetDEC != moveDEC));
+
+  //  if (stepperRA.currentPosition() != int(targetRA)) {
+  //    Serial.println("Moving RA from " + String(stepperRA.currentPosition()) + " to " + targetRA);
+  //  }
+  //  if (stepperDEC.currentPosition() != (targetDEC)) {
+  //    Serial.println("Moving DEC from " + String(stepperDEC.currentPosition()) + " to " + targetDEC);
+  //  }
+  return side;
+}
+
+/////////////////////////////////
+//
+// applyTrackingRates
+//
+/////////////////////////////////
+void Mount::applyTrackingRates() {
+  #if TRAJECTORY_FOLLOWING == 1
+  // The trajectory drives RA (including the sky's turning) and DEC itself
+  if (isFollowing()) {
+    return;
+  }
+  #endif
+
+  // In sidereal rates. The offsets are in arcseconds per second, a target moving east lags behind the sky.
+  float raRate = trackingRates[_trackingRate] - _raRateOffset / siderealArcsecondsPerSecond;
+  float decRate = _decRateOffset / siderealArcsecondsPerSecond;
+  #if REFRACTION_TRACKING == 1
+  if (_refractionTracking) {
+    raRate += _refractionRARate;
+    decRate += _refractionDECRate;
+  }
+  #endif
+
+  _stepperTRK->setSpeed(_trackingSpeed * raRate);
+
+  // DEC runs at slew microstepping. Moving north lowers the stepper position, unless the axes are turned around.
+  float decStepsPerDegree = DECAxis::stepsPerSiderealHour(_stepsPerDECDegree) / siderealDegreesInHour;
+  float decSpeed = decRate * siderealArcsecondsPerSecond / 3600.0f * decStepsPerDegree;
+  if (NORTHERN_HEMISPHERE != isPierFlipped()) {
+    decSpeed = -decSpeed;
+  }
+  if (!isDECStepperSlewing()) {
+    // interruptLoop() only steps DEC at this speed while tracking
+    _stepperDEC->setSpeed((_mountStatus & STATUS_TRACKING) ? decSpeed : 0);
+  }
+}
+
+/////////////////////////////////
+//
+// setTrackingRate
+//
+/////////////////////////////////
+void Mount::setTrackingRate(byte rate) {
+  if (rate >= TRACKING_RATES) {
+    return;
+  }
+  LOGV2(DEBUG_MOUNT, "Mount: Tracking rate %d", rate);
+  _trackingRate = rate;
+  if (isSlewingTRK()) {
+    applyTrackingRates();
+  }
+}
+
+/////////////////////////////////
+//
+// getTrackingRate
+//
+/////////////////////////////////
+byte Mount::getTrackingRate() const {
+  return _trackingRate;
+}
+
+/////////////////////////////////
+//
+// setTrackingRateOffset
+//
+/////////////////////////////////
+void Mount::setTrackingRateOffset(int which, float arcsecondsPerSecond) {
+  LOGV3(DEBUG_MOUNT, "Mount: Tracking rate offset %d is %f\"/s", which, arcsecondsPerSecond);
+  if (which == RA_STEPS) {
+    _raRateOffset = arcsecondsPerSecond;
+  }
+  else if (which == DEC_STEPS) {
+    _decRateOffset = arcsecondsPerSecond;
+  }
+  if (isSlewingTRK()) {
+    applyTrackingRates();
+  }
+}
+
+/////////////////////////////////
+//
+// getTrackingRateOffset
+//
+/////////////////////////////////
+float Mount::getTrackingRateOffset(int which) const {
+  return (which == RA_STEPS) ? _raRateOffset : (which == DEC_STEPS) ? _decRateOffset : 0;
+}
+
+/////////////////////////////////
+//
+// isDECStepperSlewing
+//
+/////////////////////////////////
+// Outside slews and guide pulses, a DEC stepper with a speed is following the DEC tracking rate (or was, until
+// tracking stopped), so whether it is running doesn't tell whether it is slewing.
+bool Mount::isDECStepperSlewing() const {
+  if (_mountStatus & STATUS_GUIDE_PULSE_DEC) {
+    return true;
+  }
+  #if DEC_DRIVER_TYPE == TMC2209_UART
+  // Still finishing a guide pulse
+  if (_decAlignment != DEC_ALIGN_NONE) {
+    return true;
+  }
+  #endif
+  return (_mountStatus & STATUS_SLEWING) && _stepperDEC->isRunning();
+}
+
+/////////////////////////////////
+//
+// trackedHours
+//
+/////////////////////////////////
+// How far the TRK stepper has turned the RA ring since home, in hours
+float Mount::trackedHours() const {
+  return _stepperTRK->currentPosition() / _trackingSpeed / 3600.0f;
+}
+
+/////////////////////////////////
+//
+// stepperHours
+//
+/////////////////////////////////
+float Mount::stepperHours(Angle ra) const {
+  Angle hourPos = ra - _zeroPosRA;
+  if (!NORTHERN_HEMISPHERE) {
+    hourPos += Angle::fromHours(12);
+  }
+
+  // Signed, so the [0 to 24] range maps to [-12 to +12]
+  return hourPos.signedHours();
+}
+
+// The DEC Mount uses is 0 at the pole and negative towards the equator, the sky uses -90 to 90.
+static Angle toSkyDEC(Angle dec) {
+  return NORTHERN_HEMISPHERE ? dec + Angle::fromDegrees(90) : Angle::fromDegrees(-90) - dec;
+}
+
+#if EPOCH_CONVERSION == 1 || TRAJECTORY_FOLLOWING == 1
+static Angle fromSkyDEC(Angle dec) {
+  return NORTHERN_HEMISPHERE ? dec - Angle::fromDegrees(90) : Angle::fromDegrees(-90) - dec;
+}
+#endif
+
+/////////////////////////////////
+//
+// getCurrentAltAz
+//
+/////////////////////////////////
+// Of the sky position, like currentRA() and currentDEC(), but in the coordinates of the date.
+void Mount::getCurrentAltAz(float& altitude, float& azimuth) const {
+  Angle ra = currentRAAngle();
+  Angle dec = currentDECAngle();
+  #if POINTING_MODEL == 1
+  applyPointingModel(ra, dec, isPierFlipped(), false);
+  #endif
+  float ha = (currentLST() - ra).signedDegrees();
+  AltAz::fromEquatorial(ha, toSkyDEC(dec).signedDegrees(), latitude(), altitude, azimuth);
+}
+
+#if REFRACTION_TRACKING == 1
+// Refraction in degrees at the given altitude (Saemundsson). Nothing to track below the horizon.
+static float refraction(float altitude) {
+  if (altitude < -1.0f) {
+    return 0;
+  }
+  return 1.02f / tan((altitude + 10.3f / (altitude + 5.11f)) * DEG_TO_RAD) / 60.0f;
+}
+
+// How far refraction moves a position in HA and DEC (degrees). It is raised towards the zenith, which is
+// in the direction of the parallactic angle.
+static void refractionOffset(float ha, float dec, float latitude, float& haOffset, float& decOffset) {
+  float sinLat = sin(latitude * DEG_TO_RAD);
+  float cosLat = cos(latitude * DEG_TO_RAD);
+  float sinDec = sin(dec * DEG_TO_RAD);
+  float cosDec = cos(dec * DEG_TO_RAD);
+  float sinHA = sin(ha * DEG_TO_RAD);
+  float cosHA = cos(ha * DEG_TO_RAD);
+
+  float altitude = asin(sinLat * sinDec + cosLat * cosDec * cosHA) * RAD_TO_DEG;
+  float parallactic = atan2(sinHA * cosLat, sinLat * cosDec - cosLat * sinDec * cosHA);
+  float offset = refraction(altitude);
+  decOffset = offset * cos(parallactic);
+  haOffset = -offset * sin(parallactic) / max(cosDec, 0.0175f);
+}
+
+/////////////////////////////////
+//
+// updateRefractionRates
+//
+/////////////////////////////////
+// The rates are the change of the refraction offsets over the next quarter degree (one minute) the sky turns.
+void Mount::updateRefractionRates() {
+  const float step = 0.25f;
+  float ha = (currentLST() - currentRAAngle()).signedDegrees();
+  float dec = toSkyDEC(currentDECAngle()).signedDegrees();
+  float haNow, decNow, haLater, decLater;
+  refractionOffset(ha, dec, latitude(), haNow, decNow);
+  refractionOffset(ha + step, dec, latitude(), haLater, decLater);
+
+  _refractionRARate = (haLater - haNow) / step;
+  _refractionDECRate = (decLater - decNow) / step;
+  _lastRefractionUpdate = millis();
+  LOGV3(DEBUG_MOUNT_VERBOSE, "Mount: Refraction rates RA %f, DEC %f", _refractionRARate, _refractionDECRate);
+  applyTrackingRates();
+}
+
+/////////////////////////////////
+//
+// setRefractionTracking
+//
+/////////////////////////////////
+void Mount::setRefractionTracking(bool enable) {
+  LOGV2(DEBUG_MOUNT, "Mount: Refraction tracking %s", enable ? "on" : "off");
+  _refractionTracking = enable;
+  if (enable) {
+    updateRefractionRates();
+  }
+  else if (isSlewingTRK()) {
+    applyTrackingRates();
+  }
+}
+
+/////////////////////////////////
+//
+// isRefractionTracking
+//
+/////////////////////////////////
+bool Mount::isRefractionTracking() const {
+  return _refractionTracking;
+}
+#endif
+
+#if TRAJECTORY_FOLLOWING == 1
+// Speed that keeps the stepper on a trajectory that moves at the given speed and is now at the given position.
+// The stepper closes any gap no faster than it could stop in, and stays within its acceleration and speed limits.
+static float followingSpeed(AccelStepper* stepper, float position, float trajectorySpeed, float maxSpeed, float maxAcceleration) {
+  const float interval = TRAJECTORY_UPDATE_INTERVAL / 1000.0f;
+  float error = position - stepper->currentPosition();
+  float braking = sqrt(2.0f * maxAcceleration * fabs(error));
+  float speed = trajectorySpeed + constrain(error / interval, -braking, braking);
+
+  float change = maxAcceleration * interval;
+  speed = constrain(speed, stepper->speed() - change, stepper->speed() + change);
+  return constrain(speed, -maxSpeed, maxSpeed);
+}
+
+/////////////////////////////////
+//
+// addWaypoint
+//
+/////////////////////////////////
+bool Mount::addWaypoint(unsigned long ms, float raHours, float decDegrees) {
+  if (decDegrees < -90.0f || decDegrees > 90.0f) {
+    return false;
+  }
+
+  // The whole pass is followed on the pier side of its first waypoint, a flip halfway would lose the target.
+  float raSteps, decSteps;
+  Angle ra = Angle::fromHours(raHours);
+  Angle dec = fromSkyDEC(Angle::fromDegrees(decDegrees));
+  byte side = (_trajectory.count() == 0) ? PIER_SIDE_AUTO : _trajectorySide;
+  side = calculateSteppers(ra, dec, true, side, raSteps, decSteps);
+  // The limits depend on the sky and the tracking when the waypoint is reached, processTrajectory() checks them then.
+  if (!_trajectory.add(ms, raSteps, decSteps)) {
+    LOGV2(DEBUG_MOUNT, "Mount: Waypoint at %l rejected", ms);
+    return false;
+  }
+
+  _trajectorySide = side;
+  LOGV4(DEBUG_MOUNT_VERBOSE, "Mount: Waypoint at %l: RA %f, DEC %f", ms, raSteps, decSteps);
+  return true;
+}
+
+/////////////////////////////////
+//
+// startFollowing
+//
+/////////////////////////////////
+bool Mount::startFollowing() {
+  if (isFollowing() || (_trajectory.count() == 0) || isParking() || isFindingHome()) {
+    return false;
+  }
+
+  LOGV2(DEBUG_MOUNT, "Mount: Start following %d waypoints", _trajectory.count());
+  if (isGuiding()) {
+    stopGuiding();
+  }
+  stopSlewing(ALL_DIRECTIONS);
+  waitUntilStopped(ALL_DIRECTIONS);
+
+  #if POSITION_CHECKPOINT == 1
+  invalidateCheckpoint();
+  #endif
+  // The TRK stepper would step at tracking microsteps while the RA driver is at slew microsteps, so it stands still
+  // and the RA stepper follows the sky as well (see trajectoryTracking()).
+  _stepperTRK->setSpeed(0);
+  #if RA_DRIVER_TYPE == TMC2209_UART
+  // The waypoints are in slew microsteps, the RA stepper runs at them for the whole pass
+  updateRAMicrostepping(true);
+  #endif
+  _stepperRA->setMaxSpeed(_maxRASpeed);
+  _stepperDEC->setMaxSpeed(_maxDECSpeed);
+  _stepperRA->setSpeed(0);
+  _stepperDEC->setSpeed(0);
+  _trajectoryStart = millis();
+  _lastTrajectoryUpdate = _trajectoryStart - TRAJECTORY_UPDATE_INTERVAL;
+  _mountStatus |= STATUS_SLEWING | STATUS_FOLLOWING;
+  startSlewing(TRACKING);
+  return true;
+}
+
+/////////////////////////////////
+//
+// stopFollowing
+//
+/////////////////////////////////
+void Mount::stopFollowing() {
+  _trajectory.clear();
+  if (!isFollowing()) {
+    return;
+  }
+
+  unsigned long time = millis() - _trajectoryStart;
+  LOGV2(DEBUG_MOUNT, "Mount: Stop following after %l ms", time);
+  _stepperRA->setSpeed(0);
+  _stepperDEC->setSpeed(0);
+
+  // Hand the sky's turning back from the RA stepper to the TRK stepper. Whole TRK steps per RA step keep the
+  // TRK stepper on its microstep grid.
+  long raSteps = lround(trajectoryTracking(time));
+  _stepperRA->setCurrentPosition(_stepperRA->currentPosition() - raSteps);
+  _stepperTRK->setCurrentPosition(_stepperTRK->currentPosition() + lround(raSteps * RAAxis::trackingStepsPerSlewStep));
+  _mountStatus &= ~(STATUS_SLEWING | STATUS_FOLLOWING);
+  _currentRAStepperPosition = _stepperRA->currentPosition();
+  _currentDECStepperPosition = _stepperDEC->currentPosition();
+  _targetRA = currentRA();
+  _targetDEC = currentDEC();
+  #if RA_DRIVER_TYPE == TMC2209_UART
+  updateRAMicrostepping(false);
+  #endif
+  applyTrackingRates();
+  #if POSITION_CHECKPOINT == 1
+  checkpointPosition();
+  #endif
+}
+
+/////////////////////////////////
+//
+// isFollowing
+//
+/////////////////////////////////
+bool Mount::isFollowing() const {
+  return (_mountStatus & STATUS_FOLLOWING) != 0;
+}
+
+/////////////////////////////////
+//
+// getWaypointCount
+//
+/////////////////////////////////
+byte Mount::getWaypointCount() const {
+  return _trajectory.count();
+}
+
+/////////////////////////////////
+//
+// getFollowingTime
+//
+/////////////////////////////////
+unsigned long Mount::getFollowingTime() const {
+  return isFollowing() ? millis() - _trajectoryStart : 0;
+}
+
+/////////////////////////////////
+//
+// processTrajectory
+//
+/////////////////////////////////
+// The interrupt runs the RA and DEC steppers at constant speed, this sets the speeds that take them to where the
+// trajectory will be at the next update.
+void Mount::processTrajectory() {
+  unsigned long now = millis();
+  if (now - _lastTrajectoryUpdate < TRAJECTORY_UPDATE_INTERVAL) {
+    return;
+  }
+  _lastTrajectoryUpdate = now;
+
+  unsigned long time = now - _trajectoryStart;
+  float raNow, decNow, raNext, decNext;
+  if (!_trajectory.position(time, raNow, decNow) || !_trajectory.position(time + TRAJECTORY_UPDATE_INTERVAL, raNext, decNext)) {
+    LOGV1(DEBUG_MOUNT, "Mount: Reached the end of the trajectory");
+    stopFollowing();
+    return;
+  }
+  raNow += trajectoryTracking(time);
+  raNext += trajectoryTracking(time + TRAJECTORY_UPDATE_INTERVAL);
+
+  #if MOUNT_LIMITS == 1
+  // The axes where the next update takes them, the horizon where the mount points now
+  if (checkLimits(currentRAAngle(), currentDECAngle(), raNext, decNext) != TARGET_REACHABLE) {
+    LOGV2(DEBUG_MOUNT, "Mount: Trajectory reaches a limit at %l ms", time);
+    stopFollowing();
+    _faultStatus |= FAULT_LIMIT;
+    return;
+  }
+  #endif
+
+  const float interval = TRAJECTORY_UPDATE_INTERVAL / 1000.0f;
+  _stepperRA->setSpeed(followingSpeed(_stepperRA, raNow, (raNext - raNow) / interval, _maxRASpeed, _maxRAAcceleration));
+  _stepperDEC->setSpeed(followingSpeed(_stepperDEC, decNow, (decNext - decNow) / interval, _maxDECSpeed, _maxDECAcceleration));
+  displayStepperPositionThrottled();
+}
+
+/////////////////////////////////
+//
+// trajectoryTracking
+//
+/////////////////////////////////
+float Mount::trajectoryTracking(unsigned long ms) const {
+  return _trackingSpeed / RAAxis::trackingStepsPerSlewStep * ms / 1000.0f;
+}
+#endif
+
+#if MANUAL_SLEW_RAMPS == 1
+// Move the speed towards the target by at most the acceleration, or the deceleration when slowing down or reversing.
+static float rampSpeed(float speed, float target, float acceleration, float deceleration, float seconds) {
+  bool slowing = ((speed > 0) && (target < speed)) || ((speed < 0) && (target > speed));
+  float change = (slowing ? deceleration : acceleration) * seconds;
+  if (fabs(target - speed) <= change) {
+    return target;
+  }
+  return (target > speed) ? speed + change : speed - change;
+}
+
+/////////////////////////////////
+//
+// processManualSlew
+//
+/////////////////////////////////
+// The interrupt runs the RA and DEC steppers at constant speed in manual slew mode, this ramps those speeds to the
+// ones last set with setSpeed(), using the acceleration and deceleration of the current slew rate preset.
+void Mount::processManualSlew() {
+  unsigned long now = millis();
+  if (now == _lastManualSlewUpdate) {
+    return;
+  }
+
+  // Don't make up for a long wait (e.g. a blocking LCD update) with one big jump
+  float seconds = min((now - _lastManualSlewUpdate) / 1000.0f, 0.05f);
+  _lastManualSlewUpdate = now;
+  float acceleration = _slewAcceleration[_moveRate - 1];
+  float deceleration = _slewDeceleration[_moveRate - 1];
+  _stepperRA->setSpeed(rampSpeed(_stepperRA->speed(), _manualRASpeed, acceleration * _maxRAAcceleration, deceleration * _maxRAAcceleration, seconds));
+  _stepperDEC->setSpeed(rampSpeed(_stepperDEC->speed(), _manualDECSpeed, acceleration * _maxDECAcceleration, deceleration * _maxDECAcceleration, seconds));
+}
+#endif
+
+/////////////////////////////////
+//
+// getRAAxisHours
+//
+/////////////////////////////////
+float Mount::getRAAxisHours() const {
+  float stepsPerSiderealHour = RAAxis::stepsPerSiderealHour(_stepsPerRADegree);
+  return trackedHours() + _stepperRA->currentPosition() / stepsPerSiderealHour;
+}
+
+#if MERIDIAN_FLIP == 1
+/////////////////////////////////
+//
+// setFlipLimit
+//
+/////////////////////////////////
+// Flipping turns the ring 12 hours east, below 6 hours west that would take it further east than it was west.
+void Mount::setFlipLimit(float hours) {
+  _flipLimit = constrain(hours, 6.0f, 12.0f);
+  LOGV2(DEBUG_MOUNT, "Mount: Flip limit is %f hours", _flipLimit);
+  checkMeridianFlip();
+}
+
+/////////////////////////////////
+//
+// getFlipLimit
+//
+/////////////////////////////////
+float Mount::getFlipLimit() const {
+  return _flipLimit;
+}
+
+/////////////////////////////////
+//
+// setAutoFlip
+//
+/////////////////////////////////
+void Mount::setAutoFlip(bool enable) {
+  LOGV2(DEBUG_MOUNT, "Mount: Automatic flip %s", enable ? "on" : "off");
+  _autoFlip = enable;
+  checkMeridianFlip();
+}
+
+/////////////////////////////////
+//
+// isAutoFlip
+//
+/////////////////////////////////
+bool Mount::isAutoFlip() const {
+  return _autoFlip;
+}
+
+/////////////////////////////////
+//
+// isFlipNeeded
+//
+/////////////////////////////////
+bool Mount::isFlipNeeded() const {
+  return _flipNeeded;
+}
+
+/////////////////////////////////
+//
+// checkMeridianFlip
 //
-// Get the current speed of the stepper. NORTH, WEST, TRACKING
 /////////////////////////////////
-float Mount::getSpeed(int direction) {
-  if (direction & TRACKING) {
-    return _trackingSpeed;
+void Mount::checkMeridianFlip() {
+  _lastFlipCheck = millis();
+  bool needed = isSlewingTRK() && (getRAAxisHours() > _flipLimit);
+  if (needed && !_flipNeeded) {
+    LOGV2(DEBUG_MOUNT, "Mount: RA ring is %f hours west, flip needed", getRAAxisHours());
   }
-  if (direction & (NORTH | SOUTH)) {
-    return _stepperDEC->speed();
+  _flipNeeded = needed;
+
+  // Not while slewing, following or guiding, those change the position themselves
+  if (_flipNeeded && _autoFlip && !isGuiding() && ((_mountStatus & STATUS_SLEWING) == 0)) {
+    startMeridianFlip();
   }
-  if (direction & (EAST | WEST)) {
-    return _stepperRA->speed();
+}
+
+/////////////////////////////////
+//
+// startMeridianFlip
+//
+/////////////////////////////////
+bool Mount::startMeridianFlip() {
+  if (!isSlewingTRK() || isParking() || isFindingHome() || (_mountStatus & STATUS_SLEWING)) {
+    return false;
   }
-  return 0;
+
+  LOGV2(DEBUG_MOUNT, "Mount: Meridian flip at %f hours west", getRAAxisHours());
+  _targetRA = currentRA();
+  _targetDEC = currentDEC();
+  byte reachable = startSlewingToTarget(isPierFlipped() ? PIER_SIDE_NORMAL : PIER_SIDE_FLIPPED);
+  if (reachable != TARGET_REACHABLE) {
+    // Still needed, the mount keeps tracking towards the limit
+    LOGV2(DEBUG_MOUNT, "Mount: Meridian flip rejected (%d)", reachable);
+    return false;
+  }
+  _flipNeeded = false;
+  return true;
 }
+#endif
 
+#if MOUNT_LIMITS == 1
+/////////////////////////////////
+//
+// setAxisLimits
+//
+/////////////////////////////////
+void Mount::setAxisLimits(float raEast, float raWest, int decPlus, int decMinus) {
+  LOGV5(DEBUG_MOUNT, "Mount: Axis limits RA %f E, %f W, DEC %d, -%d", raEast, raWest, decPlus, decMinus);
+  SiteLimits& site = EPROMStore::Storage()->config().site;
+  site.raLimitEast = constrain(raEast * 10.0f + 0.5f, 0, 240);
+  site.raLimitWest = constrain(raWest * 10.0f + 0.5f, 0, 240);
+  site.decLimitPlus = constrain(decPlus, 0, 255);
+  site.decLimitMinus = constrain(decMinus, 0, 255);
+  EPROMStore::Storage()->configChanged();
+}
+#endif
 
+#if MOUNT_LIMITS == 1 || PIER_SIDE_SELECTION == 1
 /////////////////////////////////
 //
-// calculateRAandDECSteppers
+// getAxisLimits
 //
-// This code tells the steppers to what location to move to, given the select right ascension and declination
 /////////////////////////////////
-void Mount::calculateRAandDECSteppers(float& targetRA, float& targetDEC) {
-  //LOGV3(DEBUG_MOUNT_VERBOSE,"Mount::CalcSteppersPre: Current: RA: %s, DEC: %s", currentRA().ToString(), currentDEC().ToString());
-  //LOGV3(DEBUG_MOUNT_VERBOSE,"Mount::CalcSteppersPre: Target : RA: %s, DEC: %s", _targetRA.ToString(), _targetDEC.ToString());
-  //LOGV2(DEBUG_MOUNT_VERBOSE,"Mount::CalcSteppersPre: ZeroRA : %s", _zeroPosRA.ToString());
-  //LOGV4(DEBUG_MOUNT_VERBOSE,"Mount::CalcSteppersPre: Stepper: RA: %l, DEC: %l, TRK: %l", _stepperRA->currentPosition(), _stepperDEC->currentPosition(), _stepperTRK->currentPosition());
-  DayTime raTarget = _targetRA;
+// The limits in use, the configured defaults for those that are not set. Without MOUNT_LIMITS they cannot be set,
+// but pier side selection still keeps gotos within the defaults.
+void Mount::getAxisLimits(float& raEast, float& raWest, int& decPlus, int& decMinus) const {
+  const SiteLimits& site = EPROMStore::Storage()->config().site;
+  raEast = site.raLimitEast ? site.raLimitEast / 10.0f : LIMIT_RA_EAST;
+  raWest = site.raLimitWest ? site.raLimitWest / 10.0f : LIMIT_RA_WEST;
+  decPlus = site.decLimitPlus ? site.decLimitPlus : LIMIT_DEC;
+  decMinus = site.decLimitMinus ? site.decLimitMinus : LIMIT_DEC;
+}
+#endif
+
+/////////////////////////////////
+//
+// getPierSide
+//
+/////////////////////////////////
+byte Mount::getPierSide() const {
+  return isPierFlipped() ? PIER_SIDE_FLIPPED : PIER_SIDE_NORMAL;
+}
 
-  raTarget.subtractTime(_zeroPosRA);
-  //LOGV3(DEBUG_MOUNT_VERBOSE,"Mount::CalcSteppersIn: Adjust RA by Zeropos. New Target RA: %s, DEC: %s", raTarget.ToString(), _targetDEC.ToString());
+/////////////////////////////////
+//
+// getTargetPierSide
+//
+/////////////////////////////////
+byte Mount::getTargetPierSide() const {
+  return _targetPierSide;
+}
 
-  float hourPos = raTarget.getTotalHours();
-  if (!NORTHERN_HEMISPHERE) {
-    hourPos += 12;
+#if PIER_SIDE_SELECTION == 1
+// Seconds a stepper takes to move the given number of steps, accelerating to its max speed and back
+static float slewTime(float steps, float maxSpeed, float acceleration) {
+  steps = fabs(steps);
+  if (steps < maxSpeed * maxSpeed / acceleration) {
+    // Never reaches max speed
+    return 2.0f * sqrt(steps / acceleration);
   }
-  // Map [0 to 24] range to [-12 to +12] range
-  while (hourPos > 12) {
-    hourPos = hourPos - 24;
-    //LOGV3(DEBUG_MOUNT_VERBOSE,"Mount::CalcSteppersIn: RA>12 so -24. New Target RA: %s, DEC: %s", DayTime(hourPos).ToString(), _targetDEC.ToString());
+  return steps / maxSpeed + maxSpeed / acceleration;
+}
+
+/////////////////////////////////
+//
+// choosePierSide
+//
+/////////////////////////////////
+// Both solutions are worked out from where the steppers are now. A side that leaves less than PIER_SIDE_MIN_TRACKING
+// hours before the RA limit (or the flip limit) needs a flip soon, each missing hour counts as if the slew took that long.
+// The two sides are 12 hours of RA apart, so there is only a choice where the RA limits add up to more than 12 hours.
+// With the 6 hour defaults, only a target right at the limits has two sides. The one that has just passed the west
+// limit leaves no time to track and the other side is chosen.
+byte Mount::choosePierSide() {
+  Angle ra = Angle::fromTime(_targetRA);
+  Angle dec = Angle::fromDegreeTime(_targetDEC);
+  float raEast, raWest;
+  int decPlus, decMinus;
+  getAxisLimits(raEast, raWest, decPlus, decMinus);
+  float trackingLimit = raWest;
+  #if MERIDIAN_FLIP == 1
+  trackingLimit = min(trackingLimit, _flipLimit);
+  #endif
+
+  float stepsPerSiderealHour = RAAxis::stepsPerSiderealHour(_stepsPerRADegree);
+  byte bestSide = PIER_SIDE_AUTO;
+  float bestCost = 0;
+  for (byte side = PIER_SIDE_NORMAL; side <= PIER_SIDE_FLIPPED; side++) {
+    float raSteps, decSteps;
+    calculateSteppers(ra, dec, true, side, raSteps, decSteps);
+    float ringHours = trackedHours() + raSteps / stepsPerSiderealHour;
+    float decDegrees = decSteps / _stepsPerDECDegree;
+    if ((ringHours < -raEast) || (ringHours > raWest) || (decDegrees > decPlus) || (decDegrees < -decMinus)) {
+      continue;
+    }
+
+    float cost = max(slewTime(raSteps - _stepperRA->currentPosition(), _maxRASpeed, _maxRAAcceleration),
+                     slewTime(decSteps - _stepperDEC->currentPosition(), _maxDECSpeed, _maxDECAcceleration));
+    float trackingHours = trackingLimit - ringHours;
+    if (trackingHours < PIER_SIDE_MIN_TRACKING) {
+      cost += (PIER_SIDE_MIN_TRACKING - trackingHours) * 3600.0f;
+    }
+    LOGV4(DEBUG_MOUNT_VERBOSE, "Mount: Pier side %d costs %fs, %f hours to track", side, cost, trackingHours);
+
+    if ((bestSide == PIER_SIDE_AUTO) || (cost < bestCost)) {
+      bestSide = side;
+      bestCost = cost;
+    }
   }
 
-  // How many steps moves the RA ring one sidereal hour along. One sidereal hour moves just shy of 15 degrees
-  float stepsPerSiderealHour = _stepsPerRADegree * siderealDegreesInHour;
+  LOGV2(DEBUG_MOUNT, "Mount: Chose pier side %d", bestSide);
+  return bestSide;
+}
+#endif
 
-  // Where do we want to move RA to?
-  #if RA_DRIVER_TYPE == ULN2003_DRIVER
-  float moveRA = hourPos * stepsPerSiderealHour / 2;
-  #else
-  float moveRA = hourPos * stepsPerSiderealHour;
-  #endif
+#if MOUNT_LIMITS == 1
+/////////////////////////////////
+//
+// setHorizon
+//
+/////////////////////////////////
+void Mount::setHorizon(byte sector, int altitude) {
+  if (sector >= HORIZON_SECTORS) {
+    return;
+  }
+  LOGV3(DEBUG_MOUNT, "Mount: Horizon sector %d at %d degrees", sector, altitude);
+  EPROMStore::Storage()->config().site.horizon[sector] = (altitude == HORIZON_NONE) ? HORIZON_NONE : constrain(altitude, -90, 90);
+  EPROMStore::Storage()->configChanged();
+}
 
+/////////////////////////////////
+//
+// getHorizon
+//
+/////////////////////////////////
+int Mount::getHorizon(byte sector) const {
+  return (sector < HORIZON_SECTORS) ? EPROMStore::Storage()->config().site.horizon[sector] : HORIZON_NONE;
+}
 
+/////////////////////////////////
+//
+// checkTarget
+//
+/////////////////////////////////
+byte Mount::checkTarget() {
+  float targetRA, targetDEC;
+  calculateRAandDECSteppers(targetRA, targetDEC);
+  return checkLimits(Angle::fromTime(_targetRA), Angle::fromDegreeTime(_targetDEC), targetRA, targetDEC);
+}
 
-  // Where do we want to move DEC to?
-  // the variable targetDEC 0deg for the celestial pole (90deg), and goes negative only.
-  float moveDEC = -_targetDEC.getTotalDegrees() * _stepsPerDECDegree;
+/////////////////////////////////
+//
+// checkLimits
+//
+/////////////////////////////////
+// The axes are checked first, they are what can damage the mount. The horizon needs the time and site to be set.
+byte Mount::checkLimits(Angle ra, Angle dec, float raSteps, float decSteps) const {
+  if (!isWithinAxisLimits(raSteps, decSteps)) {
+    return TARGET_OUT_OF_REACH;
+  }
 
-  //LOGV3(DEBUG_MOUNT_VERBOSE,"Mount::CalcSteppersIn: RA Steps/deg: %d   Steps/srhour: %f", _stepsPerRADegree, stepsPerSiderealHour);
-  //LOGV3(DEBUG_MOUNT_VERBOSE,"Mount::CalcSteppersIn: Target Step pos RA: %f, DEC: %f", moveRA, moveDEC);
+  float altitude, azimuth;
+  AltAz::fromEquatorial((currentLST() - ra).signedDegrees(), toSkyDEC(dec).signedDegrees(), latitude(), altitude, azimuth);
+  int horizon = EPROMStore::Storage()->config().site.horizon[int(azimuth * HORIZON_SECTORS / 360.0f) % HORIZON_SECTORS];
+  if ((horizon != HORIZON_NONE) && (altitude < horizon)) {
+    LOGV3(DEBUG_MOUNT, "Mount: Below the horizon, altitude %f at azimuth %f", altitude, azimuth);
+    return TARGET_BELOW_HORIZON;
+  }
+  return TARGET_REACHABLE;
+}
 
-  // We can move 6 hours in either direction. Outside of that we need to flip directions.
-#if RA_STEPPER_TYPE == STEP_28BYJ48
-  float RALimit = (6.0f * stepsPerSiderealHour / 2);
-#else
-  float RALimit = (6.0f * stepsPerSiderealHour);
+/////////////////////////////////
+//
+// isWithinAxisLimits
+//
+/////////////////////////////////
+bool Mount::isWithinAxisLimits(float raSteps, float decSteps) const {
+  float raEast, raWest;
+  int decPlus, decMinus;
+  getAxisLimits(raEast, raWest, decPlus, decMinus);
+
+  float ringHours = trackedHours() + raSteps / RAAxis::stepsPerSiderealHour(_stepsPerRADegree);
+  float decDegrees = decSteps / _stepsPerDECDegree;
+  if ((ringHours < -raEast) || (ringHours > raWest) || (decDegrees > decPlus) || (decDegrees < -decMinus)) {
+    LOGV3(DEBUG_MOUNT, "Mount: Out of reach, RA ring at %f h, DEC axis at %f deg", ringHours, decDegrees);
+    return false;
+  }
+  return true;
+}
 #endif
 
-  // If we reach the limit in the positive direction ...
-  if (moveRA > RALimit) {
-    //LOGV2(DEBUG_MOUNT_VERBOSE,"Mount::CalcSteppersIn: RA is past +limit: %f, DEC: %f", RALimit);
+#if POINTING_MODEL == 1
 
-    // ... turn both RA and DEC axis around
-#if RA_STEPPER_TYPE == STEP_28BYJ48
-    moveRA -= long(12.0f * stepsPerSiderealHour / 2);
-#else
-    moveRA -= long(12.0f * stepsPerSiderealHour);
-#endif
-    moveDEC = -moveDEC;
-    //LOGV3(DEBUG_MOUNT_VERBOSE,"Mount::CalcSteppersIn: Adjusted Target Step pos RA: %f, DEC: %f", moveRA, moveDEC);
+/////////////////////////////////
+//
+// applyPointingModel
+//
+/////////////////////////////////
+void Mount::applyPointingModel(Angle& ra, Angle& dec, bool flipped, bool toMount) const {
+  if (_pointingModel.points() == 0) {
+    return;
   }
-  // If we reach the limit in the negative direction...
-  else if (moveRA < -RALimit) {
-    //LOGV2(DEBUG_MOUNT_VERBOSE,"Mount::CalcSteppersIn: RA is past -limit: %f, DEC: %f", -RALimit);
-    // ... turn both RA and DEC axis around
-#if RA_STEPPER_TYPE == STEP_28BYJ48
-    moveRA += long(12.0f * stepsPerSiderealHour / 2);
-#else
-    moveRA += long(12.0f * stepsPerSiderealHour);
-#endif
-    moveDEC = -moveDEC;
-    //LOGV1(DEBUG_MOUNT_VERBOSE,"Mount::CalcSteppersPost: Adjusted Target. Moved RA, inverted DEC");
+
+  // Going back from the mount position evaluates the model there, the error is small enough for that not to matter.
+  Angle haError, decError;
+  _pointingModel.getError(currentLST() - ra, toSkyDEC(dec), flipped, haError, decError);
+  if (!NORTHERN_HEMISPHERE) {
+    decError = -decError;
   }
 
-  LOGV3(DEBUG_MOUNT,"Mount::CalcSteppersPost: Target Steps RA: %f, DEC: %f", -moveRA, moveDEC);
-  //    float targetRA = clamp(-moveRA, -RAStepperLimit, RAStepperLimit);
-  //    float targetDEC = clamp(moveDEC, DECStepperUpLimit, DECStepperDownLimit);
-  targetRA = -moveRA;
-  targetDEC = moveDEC;
+  // A larger HA is a smaller RA
+  if (toMount) {
+    ra -= haError;
+    dec += decError;
+  }
+  else {
+    ra += haError;
+    dec -= decError;
+  }
+}
 
-  // Can we get there without physical issues? (not doing anything with this yet)
-  //  isUnreachable = ((targetRA != -moveRA) || (targetDEC != moveDEC));
+/////////////////////////////////
+//
+// addPointingModelPoint
+//
+/////////////////////////////////
+// Add the difference between the target (where the mount actually points) and the stepper position to the model.
+void Mount::addPointingModelPoint() {
+  Angle skyRA = Angle::fromTime(_targetRA);
+  Angle targetDEC = Angle::fromDegreeTime(_targetDEC);
+  #if EPOCH_CONVERSION == 1
+  epochToDate(skyRA, targetDEC);
+  #endif
+  Angle skyDEC = toSkyDEC(targetDEC);
+  Angle mountRA = currentRAAngle();
+  Angle mountDEC = toSkyDEC(currentDECAngle());
+  _pointingModel.addPoint(currentLST() - skyRA, skyDEC, skyRA - mountRA, mountDEC - skyDEC, isPierFlipped());
+}
 
-  //  if (stepperRA.currentPosition() != int(targetRA)) {
-  //    Serial.println("Moving RA from " + String(stepperRA.currentPosition()) + " to " + targetRA);
-  //  }
-  //  if (stepperDEC.currentPosition() != (targetDEC)) {
-  //    Serial.println("Moving DEC from " + String(stepperDEC.currentPosition()) + " to " + targetDEC);
-  //  }
+/////////////////////////////////
+//
+// pointingModel
+//
+/////////////////////////////////
+const PointingModel& Mount::pointingModel() const {
+  return _pointingModel;
+}
+
+/////////////////////////////////
+//
+// clearPointingModel
+//
+/////////////////////////////////
+void Mount::clearPointingModel() {
+  LOGV1(DEBUG_MOUNT, "Mount: Clearing pointing model");
+  _pointingModel.clear();
+}
+#endif
+
+#if EPOCH_CONVERSION == 1
+/////////////////////////////////
+//
+// getEpoch
+//
+/////////////////////////////////
+byte Mount::getEpoch() const {
+  return _epoch;
+}
+
+/////////////////////////////////
+//
+// setEpoch
+//
+/////////////////////////////////
+void Mount::setEpoch(byte epoch) {
+  LOGV2(DEBUG_MOUNT, "Mount: Coordinates are now %s", epoch == EPOCH_J2000 ? "J2000" : "JNow");
+  _epoch = epoch == EPOCH_J2000 ? EPOCH_J2000 : EPOCH_JNOW;
+}
+
+/////////////////////////////////
+//
+// setDate
+//
+/////////////////////////////////
+// The time of day is not known, the clock starts at midnight. A day off moves J2000 coordinates by 0.14".
+void Mount::setDate(int year, int month, int day) {
+  Angle lst = currentLST();
+  _utc = Sidereal::julianDate(year, month, day, 0, 0, 0);
+  _clockTick = millis();
+  setSiderealTime(lst);
+  LOGV4(DEBUG_MOUNT, "Mount: Date set to %d-%d-%d", year, month, day);
+}
+
+/////////////////////////////////
+//
+// dateToEpoch
+//
+/////////////////////////////////
+void Mount::dateToEpoch(DayTime& ra, DegreeTime& dec) const {
+  Angle raAngle = Angle::fromTime(ra);
+  Angle decAngle = Angle::fromDegreeTime(dec);
+  dateToEpoch(raAngle, decAngle);
+  ra = raAngle.toDayTime();
+  dec = decAngle.toDegreeTime();
+}
+
+void Mount::dateToEpoch(Angle& ra, Angle& dec) const {
+  if (_epoch == EPOCH_J2000) {
+    Angle skyDEC = toSkyDEC(dec);
+    _precession.toJ2000(_utc, ra, skyDEC);
+    dec = fromSkyDEC(skyDEC);
+  }
+}
+
+/////////////////////////////////
+//
+// epochToDate
+//
+/////////////////////////////////
+void Mount::epochToDate(Angle& ra, Angle& dec) const {
+  if (_epoch == EPOCH_J2000) {
+    Angle skyDEC = toSkyDEC(dec);
+    _precession.toDate(_utc, ra, skyDEC);
+    dec = fromSkyDEC(skyDEC);
+  }
 }
+#endif
 
 /////////////////////////////////
 //
@@ -2165,32 +4056,41 @@ String Mount::RAString(byte type, byte active) {
 // Automatically home the mount. Only with TMC2209 in UART mode
 #if RA_DRIVER_TYPE == TMC2209_UART && DEC_DRIVER_TYPE == TMC2209_UART && USE_AUTOHOME == 1
 
+#define HOMING_FAST_APPROACH   1
+#define HOMING_BACK_OFF        2
+#define HOMING_SLOW_APPROACH   3
+#define HOMING_MOVE_TO_HOME    4
+
+// Approach speeds (steps/s, towards the stop) and the distance from the stop to the home position.
+#define HOMING_DEC_SPEED       3000
+#define HOMING_DEC_HOME_OFFSET 100
+#define HOMING_RA_SPEED        500
+#define HOMING_RA_HOME_OFFSET  1000
+
+// The mount being homed, for the DIAG pin interrupt handlers.
+static Mount* homingMount = NULL;
+
+static void raStallInterrupt() {
+  homingMount->stallDetected(RA_STEPS);
+}
+
+static void decStallInterrupt() {
+  homingMount->stallDetected(DEC_STEPS);
+}
+
 void Mount::startFindingHomeDEC()  {
   _driverDEC->SGTHRS(10);
   _driverDEC->microsteps(16);
   _driverDEC->rms_current(700);
-  
+  _driverDEC->flush();
 
   setManualSlewMode(true);
   _mountStatus |= STATUS_FINDING_HOME;
-  _stepperDEC->setMaxSpeed(3000);
-  _stepperDEC->setSpeed(-3000);
+  startHomingAxis(DEC_STEPS);
 }
 
 void Mount::finishFindingHomeDEC() 
 {  
-  _stepperDEC->stop();   
-   setManualSlewMode(false);
-   _stepperDEC->setMaxSpeed(1000);
-  _stepperDEC->setSpeed(1000);
-  //_stepperDEC->move(2350);
-  _stepperDEC->move(100);
-  while (_stepperDEC->run());
-  
-  setManualSlewMode(false);
-
-  delay(100);
-  
   startFindingHomeRA(); 
 }
 
@@ -2201,33 +4101,141 @@ void Mount::startFindingHomeRA()  {
   _driverRA->semin(0);  // turn off coolstep
   _driverRA->semin(5);
   //_driverRA->TCOOLTHRS(0xFF);  // turn autocurrent threshold down to prevent false reading
-  
-  setManualSlewMode(true);
-  //_mountStatus |= STATUS_FINDING_HOME;
-  
-  _stepperRA->setMaxSpeed(500);
+  _driverRA->flush();
+
   _stepperRA->setAcceleration(500);
-  _stepperRA->setSpeed(-500);
+  startHomingAxis(RA_STEPS);
 }
 
 void Mount::finishFindingHomeRA() 
 {
-  
-  _stepperRA->stop();   
-  
-  _stepperRA->setSpeed(1000);
-  //_stepperRA->move(15850.0);
-  setManualSlewMode(false);
-  _stepperRA->move(1000);  
-  
-  while (_stepperRA->run());
-  
+  _mountStatus &= ~(STATUS_FINDING_HOME | STATUS_SLEWING | STATUS_SLEWING_MANUAL);
+  _stepperWasRunning = false;
+  _stepperRA->setAcceleration(_maxRAAcceleration);
+  _stepperRA->setMaxSpeed(_maxRASpeed);
+  _stepperDEC->setMaxSpeed(_maxDECSpeed);
+  _stepperDEC->setAcceleration(_maxDECAcceleration);
+
+  startSlewing(TRACKING);
+  setHome(true);
+}
+
+/////////////////////////////////
+//
+// startHomingAxis
+//
+/////////////////////////////////
+// The DIAG pin is checked on every stepper interrupt. If the pin can also raise an external
+// interrupt (it can't on the default Mega pins), that is used as well, for a faster reaction.
+void Mount::startHomingAxis(byte axis)
+{
+  byte diagPin = (axis == RA_STEPS) ? RA_DIAG_PIN : DEC_DIAG_PIN;
+  _homingAxis = axis;
+  homingMount = this;
+  if (digitalPinToInterrupt(diagPin) != NOT_AN_INTERRUPT) {
+    attachInterrupt(digitalPinToInterrupt(diagPin), (axis == RA_STEPS) ? raStallInterrupt : decStallInterrupt, RISING);
+  }
+
+  LOGV2(DEBUG_MOUNT, "Mount: Homing %s axis", (axis == RA_STEPS) ? "RA" : "DEC");
+  setHomingPhase(HOMING_FAST_APPROACH);
+}
 
-   //setManualSlewMode(false);
-   
-   
-   startSlewing(TRACKING);
-   setHome(true);
+/////////////////////////////////
+//
+// setHomingPhase
+//
+/////////////////////////////////
+// Each axis is driven into its stop fast, backed off, driven into the stop again slowly and then
+// moved to home. The slow approach gives a repeatable stall position.
+void Mount::setHomingPhase(byte phase)
+{
+  AccelStepper* stepper = (_homingAxis == RA_STEPS) ? _stepperRA : _stepperDEC;
+  float speed = (_homingAxis == RA_STEPS) ? HOMING_RA_SPEED : HOMING_DEC_SPEED;
+  long homeOffset = (_homingAxis == RA_STEPS) ? HOMING_RA_HOME_OFFSET : HOMING_DEC_HOME_OFFSET;
+
+  LOGV3(DEBUG_MOUNT, "Mount: Homing phase %d, stall position %l", phase, _stallPosition);
+  _homingPhase = phase;
+  stepper->setMaxSpeed(speed);
+
+  switch (phase) {
+    case HOMING_FAST_APPROACH:
+    case HOMING_SLOW_APPROACH:
+      _mountStatus |= STATUS_SLEWING | STATUS_SLEWING_MANUAL;
+      stepper->setSpeed((phase == HOMING_FAST_APPROACH) ? -speed : -speed / AUTOHOME_SLOW_APPROACH_DIVISOR);
+      _stallDetected = false;
+      _stallArmed = true;
+      break;
+
+    case HOMING_BACK_OFF:
+    case HOMING_MOVE_TO_HOME:
+      // Reset the ramp state left over from the constant speed approach, then move with acceleration.
+      _mountStatus &= ~STATUS_SLEWING_MANUAL;
+      _mountStatus |= STATUS_SLEWING;
+      stepper->setCurrentPosition(stepper->currentPosition());
+      stepper->moveTo(_stallPosition + ((phase == HOMING_BACK_OFF) ? AUTOHOME_BACKOFF_STEPS : homeOffset));
+      break;
+  }
+}
+
+/////////////////////////////////
+//
+// processHoming
+//
+/////////////////////////////////
+void Mount::processHoming()
+{
+  AccelStepper* stepper = (_homingAxis == RA_STEPS) ? _stepperRA : _stepperDEC;
+
+  switch (_homingPhase) {
+    case HOMING_FAST_APPROACH:
+    case HOMING_SLOW_APPROACH:
+      if (_stallDetected) {
+        _stallDetected = false;
+        setHomingPhase((_homingPhase == HOMING_FAST_APPROACH) ? HOMING_BACK_OFF : HOMING_MOVE_TO_HOME);
+      }
+      break;
+
+    case HOMING_BACK_OFF:
+      if (!stepper->isRunning()) {
+        setHomingPhase(HOMING_SLOW_APPROACH);
+      }
+      break;
+
+    case HOMING_MOVE_TO_HOME:
+      if (!stepper->isRunning()) {
+        byte diagPin = (_homingAxis == RA_STEPS) ? RA_DIAG_PIN : DEC_DIAG_PIN;
+        if (digitalPinToInterrupt(diagPin) != NOT_AN_INTERRUPT) {
+          detachInterrupt(digitalPinToInterrupt(diagPin));
+        }
+
+        if (_homingAxis == DEC_STEPS) {
+          finishFindingHomeDEC();
+        }
+        else {
+          finishFindingHomeRA();
+        }
+      }
+      break;
+  }
+}
+
+/////////////////////////////////
+//
+// stallDetected
+//
+/////////////////////////////////
+// Runs in interrupt context. Latches where the axis stalled and stops it right away, the rest
+// of the homing sequence runs from loop().
+void Mount::stallDetected(byte axis)
+{
+  if (!_stallArmed || (axis != _homingAxis)) {
+    return;
+  }
 
+  AccelStepper* stepper = (axis == RA_STEPS) ? _stepperRA : _stepperDEC;
+  _stallArmed = false;
+  _stallPosition = stepper->currentPosition();
+  stepper->setSpeed(0);
+  _stallDetected = true;
 }
 #endif
@@ -6,10 +6,19 @@
 #include "Configuration_adv.hpp"
 #include "DayTime.hpp"
 #include "LcdMenu.hpp"
+#include "EPROMJournal.hpp"
+#include "Sidereal.hpp"
+#include "Angle.hpp"
+#include "PointingModel.hpp"
+#include "Precession.hpp"
+#include "Trajectory.hpp"
+#include "AltAz.hpp"
+#include "PolarAlignment.hpp"
 
 #if RA_DRIVER_TYPE == TMC2209_UART
  #include <TMCStepper.h>
  // If you get an error here, download the TMCstepper library from "Tools > Manage Libraries"
+ #include "TMC2209Driver.hpp"
 #endif
 
 #define NORTH                      B00000001
@@ -40,6 +49,29 @@
 #define AZIMUTH_STEPS 5
 #define ALTITUDE_STEPS 6
 
+// Tracking rates, see Mount::setTrackingRate()
+#define TRACKING_SIDEREAL 0
+#define TRACKING_LUNAR    1
+#define TRACKING_SOLAR    2
+#define TRACKING_KING     3
+#define TRACKING_RATES    4
+
+// Pier sides, see Mount::calculateSteppers()
+#define PIER_SIDE_AUTO    0
+#define PIER_SIDE_NORMAL  1
+#define PIER_SIDE_FLIPPED 2
+
+// Whether a target can be reached, see Mount::startSlewingToTarget(). Same values as the Meade :MS# reply.
+#define TARGET_REACHABLE      0
+#define TARGET_BELOW_HORIZON  1
+#define TARGET_OUT_OF_REACH   2
+
+// Progress of Mount::startLevelling()
+#define LEVEL_IDLE     0
+#define LEVEL_RUNNING  1
+#define LEVEL_DONE     2
+#define LEVEL_FAILED   3    // Not level after AUTO_LEVEL_MAX_MOVES moves
+
 #define EEPROM_RA 1
 #define EEPROM_DEC 2
 #define EEPROM_SPEED 3
@@ -109,6 +141,15 @@ public:
   void setRollCalibrationAngle(float angle);
 #endif
 
+#if GYRO_LEVEL == 1 && AZIMUTH_ALTITUDE_MOTORS == 1 && AUTO_LEVEL == 1
+  // Level the pitch of the mount with the altitude motor, see LEVEL_*.
+  void startLevelling();
+  void stopLevelling();
+  byte getLevellingState() const;
+  byte getLevellingMoves() const;
+  float getLevellingError() const;
+#endif
+
   // Returns the number of steps the given motor turns to move one degree
   int getStepsPerDegree(int which);
 
@@ -118,20 +159,30 @@ public:
 
   // Sets the slew rate of the mount. rate is between 1 (slowest) and 4 (fastest)
   void setSlewRate(int rate);
+  int getSlewRate() const;
+
+#if MANUAL_SLEW_RAMPS == 1
+  // Set or get the acceleration and deceleration of a slew rate preset (1 to 4), as fractions of the maximum acceleration.
+  void setSlewRamp(int rate, float acceleration, float deceleration);
+  void getSlewRamp(int rate, float& acceleration, float& deceleration) const;
+#endif
 
   // Set the HA time (HA is derived from LST, the setter calculates and sets LST)
   void setHA(const DayTime& haTime);
   const DayTime HA() const;
 
-  // Set the LST time (HA is derived from LST)
+  // Set the LST time (HA is derived from LST). LST keeps running at the sidereal rate from then on.
   void setLST(const DayTime& haTime);
-  const DayTime& LST() const;
+  const DayTime LST() const;
 
   void setLatitude(float lat);
   void setLongitude(float lon);
   const float latitude() const;
   const float longitude() const;
 
+  // Altitude and azimuth (north through east) in degrees of where the mount points, corrected by the pointing model.
+  void getCurrentAltAz(float& altitude, float& azimuth) const;
+
   // Get a reference to the target RA value.
   DayTime& targetRA();
 
@@ -148,8 +199,9 @@ public:
   void syncPosition(int raHour, int raMinute, int raSecond, int decDegree, int decMinute, int decSecond);
 
   // Calculates movement parameters and program steppers to move
-  // there. Must call loop() frequently to actually move.
-  void startSlewingToTarget();
+  // there. Must call loop() frequently to actually move. The pier side is chosen unless given, see PIER_SIDE_*.
+  // Returns TARGET_REACHABLE if the slew started, otherwise why the target cannot be reached.
+  byte startSlewingToTarget(byte side = PIER_SIDE_AUTO);
 
   // Various status query functions
   bool isSlewingDEC() const;
@@ -161,6 +213,139 @@ public:
   bool isParking() const;
   bool isGuiding() const;
   bool isFindingHome() const;
+
+  // Returns true if a slew was stopped because a motor stalled, or tracking or a pass because it reached a limit.
+  // Cleared when the next slew starts.
+  bool hasFault() const;
+
+  // Returns true if a motor stalled and the mount may not know where it is pointing. Cleared by a sync or by setting home.
+  bool isPositionLost() const;
+
+#if POSITION_CHECKPOINT == 1
+  // Save the stepper positions, RA zero point, LST and tracking state to EEPROM.
+  void checkpointPosition();
+
+  // Returns true if EEPROM holds a complete checkpoint (the mount was not slewing when it lost power).
+  bool hasPositionCheckpoint();
+
+  // Restore the position from the checkpoint, if there is one. Either way, checkpoints are written from now on.
+  bool resumeFromCheckpoint();
+
+  // Forget the checkpoint and start writing new ones.
+  void discardCheckpoint();
+#endif
+
+#if POINTING_MODEL == 1
+  // The model that corrects gotos, fitted to the syncs since the last home or clear.
+  const PointingModel& pointingModel() const;
+
+  // Forget the model, the next sync sets the position again.
+  void clearPointingModel();
+#endif
+
+  // Track at one of the TRACKING_* rates. The speed calibration applies to all of them.
+  void setTrackingRate(byte rate);
+  byte getTrackingRate() const;
+
+  // Motion of the target on top of the tracking rate, in arcseconds per second. RA increases east, DEC north.
+  // Use RA_STEPS or DEC_STEPS for which.
+  void setTrackingRateOffset(int which, float arcsecondsPerSecond);
+  float getTrackingRateOffset(int which) const;
+
+#if REFRACTION_TRACKING == 1
+  // Correct the tracking rates for refraction at the mount's position.
+  void setRefractionTracking(bool enable);
+  bool isRefractionTracking() const;
+#endif
+
+#if TRAJECTORY_FOLLOWING == 1
+  // Add a waypoint of a trajectory, at the given milliseconds after the start of the pass. RA is in hours and DEC
+  // in degrees (-90 to 90), in the mount's epoch. The pier side is chosen at the first waypoint and kept for the pass.
+  // Returns false if the waypoint could not be added. With MOUNT_LIMITS, the pass stops with a limit fault when it
+  // is about to leave the axis limits or goes below the horizon.
+  bool addWaypoint(unsigned long ms, float raHours, float decDegrees);
+
+  // Start following the uploaded trajectory. Returns false if there is nothing to follow.
+  bool startFollowing();
+
+  // Stop following and forget the trajectory. Tracking continues.
+  void stopFollowing();
+
+  // Returns true while the mount is following a trajectory
+  bool isFollowing() const;
+
+  // Number of waypoints held and milliseconds since the pass started (0 if not following).
+  byte getWaypointCount() const;
+  unsigned long getFollowingTime() const;
+#endif
+
+  // Hours the RA ring is turned west of home, tracking included.
+  float getRAAxisHours() const;
+
+#if MOUNT_LIMITS == 1
+  // How many hours the RA ring may turn east and west of home and how many degrees the DEC axis may turn from home
+  // towards positive and negative steps. 0 uses the default from the configuration.
+  void setAxisLimits(float raEast, float raWest, int decPlus, int decMinus);
+#endif
+#if MOUNT_LIMITS == 1 || PIER_SIDE_SELECTION == 1
+  // The axis limits in use, see setAxisLimits(). Pier side selection uses them without MOUNT_LIMITS too.
+  void getAxisLimits(float& raEast, float& raWest, int& decPlus, int& decMinus) const;
+#endif
+
+  // Pier side of the mount now and the one the last goto chose, PIER_SIDE_*.
+  byte getPierSide() const;
+  byte getTargetPierSide() const;
+
+#if MOUNT_LIMITS == 1
+  // Lowest altitude in degrees the mount may point at in a sector of the horizon mask, HORIZON_NONE if the sector is not masked.
+  void setHorizon(byte sector, int altitude);
+  int getHorizon(byte sector) const;
+
+  // Returns whether the target can be reached, TARGET_*.
+  byte checkTarget();
+#endif
+
+#if MERIDIAN_FLIP == 1
+  // Hours west of home the RA ring may turn while tracking before the mount needs to flip (6 to 12).
+  void setFlipLimit(float hours);
+  float getFlipLimit() const;
+
+  // Flip when the limit is reached, otherwise only report that a flip is needed.
+  void setAutoFlip(bool enable);
+  bool isAutoFlip() const;
+
+  // Returns true if tracking has turned the RA ring past the flip limit.
+  bool isFlipNeeded() const;
+
+  // Slew to the current position on the other side of the pier. Returns false if the mount is not tracking, is busy
+  // or the other side is out of reach, the flip is then still needed.
+  bool startMeridianFlip();
+#endif
+
+#if EPOCH_CONVERSION == 1
+  // Epoch of the coordinates the mount is given and reports, EPOCH_JNOW or EPOCH_J2000.
+  byte getEpoch() const;
+  void setEpoch(byte epoch);
+
+  // Set the UT date. Only used to convert between J2000 and JNow, LST is set separately.
+  void setDate(int year, int month, int day);
+
+  // Convert coordinates of date (like Polaris' position) to the epoch the mount is given coordinates in.
+  void dateToEpoch(DayTime& ra, DegreeTime& dec) const;
+#endif
+
+  // Switch to another set of calibration values (steps, speed, backlash, location, level offsets). Only while
+  // the mount stands still at home.
+  bool selectProfile(byte index);
+
+  // Index of the active profile.
+  byte getProfile() const;
+
+  // Name of the given profile, empty if it is not in use.
+  String getProfileName(byte index) const;
+
+  // Rename the active profile.
+  void setProfileName(String name);
   #if AZIMUTH_ALTITUDE_MOTORS == 1
   bool isRunningAZ() const;
   bool isRunningALT() const;
@@ -204,6 +389,11 @@ public:
     void finishFindingHomeDEC();
   #endif
 
+  #if RA_DRIVER_TYPE == TMC2209_UART && DEC_DRIVER_TYPE == TMC2209_UART && USE_AUTOHOME == 1
+    // Called from interrupt context when the DIAG pin of the given axis (RA_STEPS or DEC_STEPS) signals a stall.
+    void stallDetected(byte axis);
+  #endif
+
   // Asynchronously parks the mount. Moves to the home position and stops all motors. 
   void park();
 
@@ -244,6 +434,15 @@ public:
   void enableAzAltMotors();
 #endif
 
+#if AZIMUTH_ALTITUDE_MOTORS == 1 && POLAR_ALIGNMENT == 1
+  // Closed loop polar alignment. Start it, then pass in each measurement of the correction the polar axis needs
+  // (arcminutes, signs as for moveBy()). Returns the POLAR_ALIGN_* state after the measurement.
+  void startPolarAlignment();
+  byte polarAlignmentMeasured(float azError, float altError);
+  void stopPolarAlignment();
+  const PolarAlignment& polarAlignment() const;
+#endif
+
   // Set the number of steps to use for backlash correction
   void setBacklashCorrection(int steps);
 
@@ -269,10 +468,115 @@ private:
   // Writes a 16-bit value to persistent (EEPROM) storage
   void writePersistentData(int which, int val);
 
-  void calculateRAandDECSteppers(float& targetRA, float& targetDEC);
+  byte calculateRAandDECSteppers(float& targetRA, float& targetDEC, byte side = PIER_SIDE_AUTO);
   void displayStepperPosition();
+
+  // Set the TRK and DEC stepper speeds from the tracking rates. DEC only tracks while tracking is on and it is not
+  // slewing or guiding.
+  void applyTrackingRates();
+
+  // Returns true if the DEC stepper is slewing or guiding, rather than following (or having followed) the DEC tracking rate.
+  bool isDECStepperSlewing() const;
+
+  // Stepper positions for the given position. Returns the pier side used, see PIER_SIDE_*.
+  byte calculateSteppers(Angle ra, Angle dec, bool skyPosition, byte side, float& targetRA, float& targetDEC);
+
+#if TRAJECTORY_FOLLOWING == 1
+  // Set the RA and DEC stepper speeds that keep them on the trajectory, run from loop() while following.
+  void processTrajectory();
+
+  // RA stepper steps the sky turns in the given milliseconds of a pass. TRK stands still while following, RA moves them too.
+  float trajectoryTracking(unsigned long ms) const;
+#endif
+
+#if MANUAL_SLEW_RAMPS == 1
+  // Ramp the RA and DEC stepper speeds towards the manual slew speeds, run from loop() in manual slew mode.
+  void processManualSlew();
+#endif
+
+#if GYRO_LEVEL == 1 && AZIMUTH_ALTITUDE_MOTORS == 1 && AUTO_LEVEL == 1
+  // Read the pitch once the altitude motor has settled and make the next move, run from loop() while levelling.
+  void processLevelling();
+#endif
+
+#if MERIDIAN_FLIP == 1
+  // See whether the RA ring has passed the flip limit and flip if that is automatic.
+  void checkMeridianFlip();
+#endif
+
+#if PIER_SIDE_SELECTION == 1
+  // The pier side that reaches the target soonest and leaves enough time to track, PIER_SIDE_AUTO if neither can reach it.
+  byte choosePierSide();
+#endif
+
+#if MOUNT_LIMITS == 1
+  // Returns whether the mount can point at the given position (internal DEC) with the given stepper positions, TARGET_*.
+  byte checkLimits(Angle ra, Angle dec, float raSteps, float decSteps) const;
+
+  // Returns whether the RA ring and DEC axis are within the axis limits at the given stepper positions.
+  bool isWithinAxisLimits(float raSteps, float decSteps) const;
+#endif
+
+#if REFRACTION_TRACKING == 1
+  // Recalculate the refraction rates for the current position and apply them.
+  void updateRefractionRates();
+#endif
   void moveSteppersTo(float targetRA, float targetDEC);
 
+#if RA_DRIVER_TYPE == TMC2209_UART
+  // Switch the RA driver between slew and tracking microstepping, depending on whether RA is about to slew.
+  void updateRAMicrostepping(bool slewing);
+#endif
+
+#if DEC_DRIVER_TYPE == TMC2209_UART
+  // Convert the DEC position of a finished guide pulse back to slew microsteps and switch the driver back. Run from
+  // loop() once interruptLoop() has moved DEC onto the slew microstep grid, or before the DEC position is set.
+  void finishDECAlignment();
+#endif
+
+#if RA_DRIVER_TYPE == TMC2209_UART && DEC_DRIVER_TYPE == TMC2209_UART && USE_AUTOHOME == 1
+  // Homing state machine, run from loop() while finding home.
+  void startHomingAxis(byte axis);
+  void setHomingPhase(byte phase);
+  void processHoming();
+#endif
+
+  // Sidereal clock helpers, see _utc.
+  void updateSiderealClock();
+  Angle currentLST() const;
+  void setSiderealTime(Angle lst);
+
+  // Where the steppers point, before it is turned into DayTime/DegreeTime for display.
+  Angle currentRAAngle() const;
+  Angle currentDECAngle() const;
+  bool isPierFlipped() const;
+
+  // Where the telescope points in the sky. The stepper position corrected by the pointing model, in the mount's epoch.
+  void currentSkyPosition(Angle& ra, Angle& dec) const;
+
+  // RA stepper position in sidereal hours for the given RA, -12 to 12 before turning the axes around.
+  float stepperHours(Angle ra) const;
+
+  // Hours the TRK stepper has turned the RA ring since home.
+  float trackedHours() const;
+
+#if POINTING_MODEL == 1
+  // Correct ra and dec (internal DEC) from sky to mount coordinates (toMount) or back.
+  void applyPointingModel(Angle& ra, Angle& dec, bool flipped, bool toMount) const;
+  void addPointingModelPoint();
+#endif
+
+#if EPOCH_CONVERSION == 1
+  // Convert ra and dec (internal DEC) between the mount's epoch and the equator of date.
+  void epochToDate(Angle& ra, Angle& dec) const;
+  void dateToEpoch(Angle& ra, Angle& dec) const;
+#endif
+
+#if POSITION_CHECKPOINT == 1
+  // Mark the checkpoint as stale before the steppers move.
+  void invalidateCheckpoint();
+#endif
+
   // Returns NOT_SLEWING, SLEWING_DEC, SLEWING_RA, or SLEWING_BOTH. SLEWING_TRACKING is an overlaid bit.
   byte slewStatus() const;
 
@@ -289,6 +593,8 @@ private:
   LcdMenu* _lcdMenu;
   int  _stepsPerRADegree;
   int _stepsPerDECDegree;
+  int _defaultStepsPerRADegree;   // Used when the profile has not stored the steps
+  int _defaultStepsPerDECDegree;
   int _maxRASpeed;
   int _maxDECSpeed;
   int _maxRAAcceleration;
@@ -299,10 +605,30 @@ private:
   float _pitchCalibrationAngle;
   float _rollCalibrationAngle;
 #endif
+#if GYRO_LEVEL == 1 && AZIMUTH_ALTITUDE_MOTORS == 1 && AUTO_LEVEL == 1
+  byte _levelState;
+  byte _levelMoves;
+  float _levelError;        // Pitch error at the last reading, degrees
+  float _levelMove;         // Last altitude move, arcminutes
+  float _levelResponse;     // Degrees of pitch error removed per arcminute moved, learnt from the moves
+  unsigned long _lastLevelUpdate;
+#endif
 
-  long _lastHASet;
-  DayTime _LST;
-  DayTime _zeroPosRA;
+  // The sidereal clock. LST is the GMST of _utc plus _lstOffset. _utc is advanced from millis() by
+  // updateSiderealClock(), so it only has to run once per millis() wrap (49 days).
+  JulianDate _utc;
+  unsigned long _clockTick;
+  Angle _lstOffset;
+  // RA at RA stepper position 0
+  Angle _zeroPosRA;
+#if POINTING_MODEL == 1
+  PointingModel _pointingModel;
+#endif
+#if EPOCH_CONVERSION == 1
+  byte _epoch;
+  // Caches the rotation for the date, which the const conversions update
+  mutable Precession _precession;
+#endif
 
   DayTime _targetRA;
   long _currentRAStepperPosition;
@@ -320,13 +646,29 @@ private:
   AccelStepper* _stepperDEC;
   AccelStepper* _stepperTRK;
   #if RA_DRIVER_TYPE == TMC2209_UART
-    TMC2209Stepper* _driverRA;
-    TMC2209Stepper* _driverDEC;
+    TMC2209Driver* _driverRA;
+    TMC2209Driver* _driverDEC;
+    long _trackingPhaseOffset;
+    long _guideStartDECPosition;
+    volatile byte _raAlignment;
+    volatile byte _decAlignment;
   #endif  
+  #if RA_DRIVER_TYPE == TMC2209_UART && DEC_DRIVER_TYPE == TMC2209_UART && USE_AUTOHOME == 1
+    byte _homingAxis;
+    byte _homingPhase;
+    volatile bool _stallArmed;
+    volatile bool _stallDetected;
+    volatile long _stallPosition;
+  #endif
   #if AZIMUTH_ALTITUDE_MOTORS == 1
     AccelStepper* _stepperAZ;
     AccelStepper* _stepperALT;
     bool _azAltWasRunning;
+    char _azDirection;     // Sign of the last move, 0 until the first one
+    char _altDirection;
+  #endif
+  #if AZIMUTH_ALTITUDE_MOTORS == 1 && POLAR_ALIGNMENT == 1
+    PolarAlignment _polarAlignment;
   #endif
 
   unsigned long _guideEndTime;
@@ -334,8 +676,49 @@ private:
   unsigned long _lastTrackingPrint = 0;
   float _trackingSpeed;
   float _trackingSpeedCalibration;
+  byte _trackingRate;
+  float _raRateOffset;        // Arcseconds per second
+  float _decRateOffset;
+#if REFRACTION_TRACKING == 1
+  bool _refractionTracking;
+  float _refractionRARate;    // Change of the RA tracking rate, as a fraction of sidereal
+  float _refractionDECRate;   // DEC degrees per degree the sky turns
+  unsigned long _lastRefractionUpdate;
+#endif
+#if TRAJECTORY_FOLLOWING == 1
+  Trajectory _trajectory;
+  byte _trajectorySide;
+  unsigned long _trajectoryStart;
+  unsigned long _lastTrajectoryUpdate;
+#endif
+  byte _targetPierSide;
+#if MANUAL_SLEW_RAMPS == 1
+  float _slewAcceleration[4];   // Per slew rate preset, fraction of the maximum acceleration
+  float _slewDeceleration[4];
+  float _manualRASpeed;         // Speeds the manual slew is ramping to, steps/sec
+  float _manualDECSpeed;
+  unsigned long _lastManualSlewUpdate;
+#endif
+#if MOUNT_LIMITS == 1
+  unsigned long _lastLimitCheck;
+#endif
+#if MERIDIAN_FLIP == 1
+  float _flipLimit;
+  bool _autoFlip;
+  bool _flipNeeded;
+  unsigned long _lastFlipCheck;
+#endif
   unsigned long _lastDisplayUpdate;
   volatile int _mountStatus;
+  volatile byte _faultStatus;
+  volatile bool _positionLost;  // Set by interruptLoop() on a stall
+#if POSITION_CHECKPOINT == 1
+  // Checkpoints are only written once we know the old one is no longer needed.
+  bool _checkpointEnabled;
+  bool _checkpointValid;
+  unsigned long _lastCheckpoint;
+  EPROMJournal* _checkpointJournal;
+#endif
   char scratchBuffer[24];
   bool _stepperWasRunning;
   bool _correctForBacklash;
@@ -0,0 +1,215 @@
+#include "Configuration_adv.hpp"
+
+#if POINTING_MODEL == 1
+#include <math.h>
+#include "Utility.hpp"
+#include "PointingModel.hpp"
+#include "FastTrig.hpp"
+
+#define ARCSECONDS_PER_RADIAN 206264.806f
+// Keeps sec(dec) and tan(dec) finite near the pole (about 89 degrees)
+#define MIN_COS_DEC           0.0175f
+// Pivots smaller than this mean the points can't tell the terms apart
+#define MIN_PIVOT             1e-6f
+
+PointingModel::PointingModel()
+{
+  clear();
+}
+
+void PointingModel::clear()
+{
+  _count = 0;
+  _next = 0;
+  for (byte i = 0; i < MODEL_TERMS; i++)
+  {
+    _terms[i] = 0;
+  }
+}
+
+// Store the point, replacing the oldest one once all are used, and refit
+void PointingModel::addPoint(Angle ha, Angle dec, Angle haError, Angle decError, bool flipped)
+{
+  SyncPoint& point = _points[_next];
+  point.ha = ha.signedDegrees() * DEG_TO_RAD;
+  point.dec = dec.signedDegrees() * DEG_TO_RAD;
+  point.haError = haError.signedDegrees() * DEG_TO_RAD;
+  point.decError = decError.signedDegrees() * DEG_TO_RAD;
+  point.side = flipped ? -1 : 1;
+
+  _next = (_next + 1) % POINTING_MODEL_POINTS;
+  if (_count < POINTING_MODEL_POINTS)
+  {
+    _count++;
+  }
+
+  LOGV3(DEBUG_MOUNT, "Model: Added point, error HA %f\", DEC %f\"", point.haError * ARCSECONDS_PER_RADIAN, point.decError * ARCSECONDS_PER_RADIAN);
+  fit();
+}
+
+void PointingModel::getError(Angle ha, Angle dec, bool flipped, Angle& haError, Angle& decError) const
+{
+  SyncPoint point;
+  point.ha = ha.signedDegrees() * DEG_TO_RAD;
+  point.dec = dec.signedDegrees() * DEG_TO_RAD;
+  point.side = flipped ? -1 : 1;
+
+  float haRow[MODEL_TERMS];
+  float decRow[MODEL_TERMS];
+  getPartials(point, haRow, decRow);
+
+  float dHA = 0;
+  float dDEC = 0;
+  for (byte i = 0; i < MODEL_TERMS; i++)
+  {
+    dHA += haRow[i] * _terms[i];
+    dDEC += decRow[i] * _terms[i];
+  }
+
+  haError = Angle::fromDegrees(dHA * RAD_TO_DEG);
+  decError = Angle::fromDegrees(dDEC * RAD_TO_DEG);
+}
+
+byte PointingModel::points() const
+{
+  return _count;
+}
+
+float PointingModel::term(byte index) const
+{
+  return (index < MODEL_TERMS) ? _terms[index] * ARCSECONDS_PER_RADIAN : 0;
+}
+
+// How much each term moves HA and DEC at the given point
+void PointingModel::getPartials(const SyncPoint& point, float* haRow, float* decRow)
+{
+#if FAST_TRIG == 1
+  uint16_t ha = FastTrig::fromDegrees(point.ha * RAD_TO_DEG);
+  uint16_t dec = FastTrig::fromDegrees(point.dec * RAD_TO_DEG);
+  float sinHA = FastTrig::sin(ha) * (1.0f / TRIG_ONE);
+  float cosHA = FastTrig::cos(ha) * (1.0f / TRIG_ONE);
+  float cosDEC = FastTrig::cos(dec) * (1.0f / TRIG_ONE);
+  float sinDEC = FastTrig::sin(dec) * (1.0f / TRIG_ONE);
+#else
+  float sinHA = sin(point.ha);
+  float cosHA = cos(point.ha);
+  float cosDEC = cos(point.dec);
+  float sinDEC = sin(point.dec);
+#endif
+  if (fabs(cosDEC) < MIN_COS_DEC)
+  {
+    cosDEC = (cosDEC < 0) ? -MIN_COS_DEC : MIN_COS_DEC;
+  }
+  float secDEC = 1.0f / cosDEC;
+  float tanDEC = sinDEC * secDEC;
+
+  haRow[MODEL_IH] = 1;
+  haRow[MODEL_ID] = 0;
+  haRow[MODEL_CH] = point.side * secDEC;
+  haRow[MODEL_NP] = point.side * tanDEC;
+  haRow[MODEL_MA] = -cosHA * tanDEC;
+  haRow[MODEL_ME] = sinHA * tanDEC;
+
+  decRow[MODEL_IH] = 0;
+  decRow[MODEL_ID] = point.side;
+  decRow[MODEL_CH] = 0;
+  decRow[MODEL_NP] = 0;
+  decRow[MODEL_MA] = sinHA;
+  decRow[MODEL_ME] = cosHA;
+}
+
+// Fit as many terms as the points allow. Points that are too close together to separate the
+// terms make the solve fail, then fewer terms are fitted.
+void PointingModel::fit()
+{
+  byte terms = (_count >= 3) ? MODEL_TERMS : (_count == 2 ? 4 : 2);
+  for (; terms >= 2; terms -= 2)
+  {
+    if (solve(terms))
+    {
+      LOGV8(DEBUG_MOUNT, "Model: %d terms. IH %f\" ID %f\" CH %f\" NP %f\" MA %f\" ME %f\"", terms, term(MODEL_IH), term(MODEL_ID), term(MODEL_CH), term(MODEL_NP), term(MODEL_MA), term(MODEL_ME));
+      return;
+    }
+  }
+
+  LOGV1(DEBUG_MOUNT, "Model: Could not fit any terms");
+  clear();
+}
+
+// Least squares fit of the first 'terms' terms in the order IH, ID, MA, ME, CH, NP, through the normal equations.
+bool PointingModel::solve(byte terms)
+{
+  static const byte order[MODEL_TERMS] = { MODEL_IH, MODEL_ID, MODEL_MA, MODEL_ME, MODEL_CH, MODEL_NP };
+  float normal[MODEL_TERMS][MODEL_TERMS + 1];
+  for (byte r = 0; r < terms; r++)
+  {
+    for (byte c = 0; c <= terms; c++)
+    {
+      normal[r][c] = 0;
+    }
+  }
+
+  for (byte p = 0; p < _count; p++)
+  {
+    float haRow[MODEL_TERMS];
+    float decRow[MODEL_TERMS];
+    getPartials(_points[p], haRow, decRow);
+    for (byte r = 0; r < terms; r++)
+    {
+      for (byte c = 0; c < terms; c++)
+      {
+        normal[r][c] += haRow[order[r]] * haRow[order[c]] + decRow[order[r]] * decRow[order[c]];
+      }
+      normal[r][terms] += haRow[order[r]] * _points[p].haError + decRow[order[r]] * _points[p].decError;
+    }
+  }
+
+  // Gauss-Jordan elimination with partial pivoting
+  for (byte col = 0; col < terms; col++)
+  {
+    byte pivot = col;
+    for (byte r = col + 1; r < terms; r++)
+    {
+      if (fabs(normal[r][col]) > fabs(normal[pivot][col]))
+      {
+        pivot = r;
+      }
+    }
+    if (fabs(normal[pivot][col]) < MIN_PIVOT)
+    {
+      return false;
+    }
+    if (pivot != col)
+    {
+      for (byte c = 0; c <= terms; c++)
+      {
+        float swap = normal[col][c];
+        normal[col][c] = normal[pivot][c];
+        normal[pivot][c] = swap;
+      }
+    }
+    for (byte r = 0; r < terms; r++)
+    {
+      if (r != col)
+      {
+        float factor = normal[r][col] / normal[col][col];
+        for (byte c = col; c <= terms; c++)
+        {
+          normal[r][c] -= factor * normal[col][c];
+        }
+      }
+    }
+  }
+
+  for (byte i = 0; i < MODEL_TERMS; i++)
+  {
+    _terms[i] = 0;
+  }
+  for (byte r = 0; r < terms; r++)
+  {
+    _terms[order[r]] = normal[r][terms] / normal[r][r];
+  }
+  return true;
+}
+
+#endif
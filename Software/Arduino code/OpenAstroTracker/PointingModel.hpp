@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Configuration_adv.hpp"
+#include "Angle.hpp"
+
+#if POINTING_MODEL == 1
+
+// The mount error terms, in the order of PointingModel::term()
+#define MODEL_IH  0   // HA index error
+#define MODEL_ID  1   // DEC index error
+#define MODEL_CH  2   // Collimation (cone) error
+#define MODEL_NP  3   // Non-perpendicularity of the RA and DEC axes
+#define MODEL_MA  4   // Polar axis left/right of the pole
+#define MODEL_ME  5   // Polar axis above/below the pole
+#define MODEL_TERMS 6
+
+//////////////////////////////////////////////////////////////////
+//
+// Pointing model fitted to sync points.
+//
+// Each sync records where the mount thought it was pointing and where it actually was. The
+// standard equatorial mount error terms are fitted to those differences by least squares:
+//
+//   dHA  = IH + s CH sec(dec) + s NP tan(dec) - MA cos(ha) tan(dec) + ME sin(ha) tan(dec)
+//   dDEC = s ID + MA sin(ha) + ME cos(ha)
+//
+// where s is -1 when the mount is on the other side of the pier. One point only fits the index
+// terms, two points add the polar axis terms, three or more fit all six. The fit runs once per
+// sync. Applying the model takes the sine and cosine of HA and DEC, from the FastTrig tables when
+// FAST_TRIG is on (that changes a correction by less than 1%), else from the math library.
+//
+// The points are kept in RAM only, polar alignment changes every time the mount is set up.
+//////////////////////////////////////////////////////////////////
+class PointingModel {
+public:
+  PointingModel();
+
+  // Forget all points and terms.
+  void clear();
+
+  // Add a sync point. ha and dec are where the mount was actually pointing (dec -90 to 90),
+  // haError and decError are what the mount thought minus that.
+  void addPoint(Angle ha, Angle dec, Angle haError, Angle decError, bool flipped);
+
+  // Get the pointing error at the given position. Add it to a sky position to get where to point the mount.
+  void getError(Angle ha, Angle dec, bool flipped, Angle& haError, Angle& decError) const;
+
+  // Number of points the model is fitted to.
+  byte points() const;
+
+  // Fitted term in arcseconds, one of MODEL_*.
+  float term(byte index) const;
+
+private:
+  struct SyncPoint {
+    float ha;           // Radians
+    float dec;
+    float haError;
+    float decError;
+    int8_t side;        // 1 or -1 on the other side of the pier
+  };
+
+  void fit();
+  bool solve(byte terms);
+  static void getPartials(const SyncPoint& point, float* haRow, float* decRow);
+
+  SyncPoint _points[POINTING_MODEL_POINTS];
+  byte _count;
+  byte _next;
+  float _terms[MODEL_TERMS];    // Radians
+};
+
+#endif
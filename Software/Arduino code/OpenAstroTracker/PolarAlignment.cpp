@@ -0,0 +1,107 @@
+#include "Configuration_adv.hpp"
+
+#if AZIMUTH_ALTITUDE_MOTORS == 1 && POLAR_ALIGNMENT == 1
+#include "Utility.hpp"
+#include "PolarAlignment.hpp"
+
+PolarAlignment::PolarAlignment()
+{
+  reset();
+}
+
+void PolarAlignment::reset()
+{
+  _azimuth.error = _altitude.error = 0;
+  _azimuth.move = _altitude.move = 0;
+  _azimuth.response = _altitude.response = 1.0f;
+  _state = POLAR_ALIGN_IDLE;
+  _iteration = 0;
+}
+
+void PolarAlignment::start()
+{
+  reset();
+  _state = POLAR_ALIGN_MEASURE;
+}
+
+bool PolarAlignment::measure(float azError, float altError, float& azMove, float& altMove)
+{
+  if (_iteration > 0)
+  {
+    learn(_azimuth, azError);
+    learn(_altitude, altError);
+  }
+  _azimuth.error = azError;
+  _altitude.error = altError;
+
+  if ((fabs(azError) <= POLAR_ALIGN_TOLERANCE) && (fabs(altError) <= POLAR_ALIGN_TOLERANCE))
+  {
+    LOGV3(DEBUG_MOUNT, "PolarAlign: Aligned after %d corrections, error %f", _iteration, max(fabs(azError), fabs(altError)));
+    _state = POLAR_ALIGN_DONE;
+    return false;
+  }
+  if (_iteration >= POLAR_ALIGN_MAX_ITERATIONS)
+  {
+    LOGV2(DEBUG_MOUNT, "PolarAlign: Not aligned after %d corrections", _iteration);
+    _state = POLAR_ALIGN_FAILED;
+    return false;
+  }
+
+  _iteration++;
+  azMove = correction(_azimuth);
+  altMove = correction(_altitude);
+  LOGV4(DEBUG_MOUNT, "PolarAlign: Correction %d is AZ %f, ALT %f arcminutes", _iteration, azMove, altMove);
+  _state = POLAR_ALIGN_MOVING;
+  return true;
+}
+
+void PolarAlignment::moved()
+{
+  if (_state == POLAR_ALIGN_MOVING)
+  {
+    _state = POLAR_ALIGN_MEASURE;
+  }
+}
+
+byte PolarAlignment::state() const
+{
+  return _state;
+}
+
+byte PolarAlignment::iteration() const
+{
+  return _iteration;
+}
+
+float PolarAlignment::azError() const
+{
+  return _azimuth.error;
+}
+
+float PolarAlignment::altError() const
+{
+  return _altitude.error;
+}
+
+// Only moves well above the tolerance say something about the response. One that comes out far from 1 is more
+// likely a bad measurement (or backlash that wasn't taken up) than the mount, so that is ignored as well.
+void PolarAlignment::learn(AxisState& axis, float error)
+{
+  if (fabs(axis.move) < 2 * POLAR_ALIGN_TOLERANCE)
+  {
+    return;
+  }
+  float response = (axis.error - error) / axis.move;
+  if ((response > 0.25f) && (response < 4.0f))
+  {
+    axis.response = response;
+  }
+}
+
+float PolarAlignment::correction(AxisState& axis)
+{
+  axis.move = (fabs(axis.error) > POLAR_ALIGN_TOLERANCE) ? axis.error / axis.response : 0;
+  return axis.move;
+}
+
+#endif
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <Arduino.h>
+#include "Configuration_adv.hpp"
+
+#if AZIMUTH_ALTITUDE_MOTORS == 1 && POLAR_ALIGNMENT == 1
+
+#define POLAR_ALIGN_IDLE      0
+#define POLAR_ALIGN_MOVING    1   // The motors are making a correction
+#define POLAR_ALIGN_MEASURE   2   // Waiting for the client to measure the polar axis again
+#define POLAR_ALIGN_DONE      3   // The last measurement was within POLAR_ALIGN_TOLERANCE
+#define POLAR_ALIGN_FAILED    4   // Still not aligned after POLAR_ALIGN_MAX_ITERATIONS corrections
+
+//////////////////////////////////////////////////////////////////
+//
+// Closed loop polar alignment with the azimuth and altitude motors.
+//
+// A client measures how far the polar axis is from the pole (e.g. by plate solving) and passes it in as the
+// azimuth and altitude correction that is needed, in arcminutes with the signs of :MAZ and :MAL. Each
+// correction is the error divided by how far the axis turns per arcminute commanded. That starts at 1 and is
+// re-estimated on each axis from how much the error changed after the last correction, so a wrong
+// ARC_SECONDS_PER_STEP or a soft mount costs one extra iteration instead of an oscillation.
+//////////////////////////////////////////////////////////////////
+class PolarAlignment {
+public:
+  PolarAlignment();
+
+  // Start over, forgetting the measurements and the estimated response. start() then waits for the first measurement.
+  void reset();
+  void start();
+
+  // A new measurement. Returns true and the corrections to make if the axis is not within tolerance yet,
+  // otherwise the alignment is done (or failed) and it returns false.
+  bool measure(float azError, float altError, float& azMove, float& altMove);
+
+  // The motors finished the last correction.
+  void moved();
+
+  byte state() const;
+  byte iteration() const;
+  float azError() const;
+  float altError() const;
+
+private:
+  struct AxisState {
+    float error;      // Last measured error, arcminutes
+    float move;       // Last correction commanded, arcminutes
+    float response;   // Arcminutes the error changes per arcminute commanded
+  };
+
+  static void learn(AxisState& axis, float error);
+  static float correction(AxisState& axis);
+
+  AxisState _azimuth;
+  AxisState _altitude;
+  byte _state;
+  byte _iteration;
+};
+
+#endif
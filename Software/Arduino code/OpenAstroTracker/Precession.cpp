@@ -0,0 +1,103 @@
+#include "Configuration_adv.hpp"
+
+#if EPOCH_CONVERSION == 1
+#include <math.h>
+#include "Utility.hpp"
+#include "Precession.hpp"
+
+#define ARCSECONDS_TO_RADIANS   (DEG_TO_RAD / 3600.0f)
+#define MS_PER_HOUR             3600000UL
+
+Precession::Precession()
+{
+  _hour = 0;
+  _valid = false;
+}
+
+void Precession::toDate(const JulianDate& date, Angle& ra, Angle& dec)
+{
+  update(date);
+  rotate(ra, dec, false);
+}
+
+void Precession::toJ2000(const JulianDate& date, Angle& ra, Angle& dec)
+{
+  update(date);
+  rotate(ra, dec, true);
+}
+
+// Recompute the matrix if the date moved EPOCH_UPDATE_HOURS away from the one it was computed for
+void Precession::update(const JulianDate& date)
+{
+  long hour = date.days * 24L + date.msOfDay / MS_PER_HOUR;
+  if (_valid && (labs(hour - _hour) < EPOCH_UPDATE_HOURS))
+  {
+    return;
+  }
+
+  float t = (date.days + 1.0f * date.msOfDay / (24 * MS_PER_HOUR)) / 36525.0f;
+
+  // Precession angles (Lieske 1977)
+  float zeta = ((0.017998f * t + 0.30188f) * t + 2306.2181f) * t * ARCSECONDS_TO_RADIANS;
+  float z = ((0.018203f * t + 1.09468f) * t + 2306.2181f) * t * ARCSECONDS_TO_RADIANS;
+  float theta = ((-0.041833f * t - 0.42665f) * t + 2004.3109f) * t * ARCSECONDS_TO_RADIANS;
+
+  // Nutation, the four largest terms (Meeus, chapter 22)
+  float node = (125.04452f - 1934.136261f * t) * DEG_TO_RAD;
+  float sun = 2.0f * (280.4665f + 36000.7698f * t) * DEG_TO_RAD;
+  float moon = 2.0f * (218.3165f + 481267.8813f * t) * DEG_TO_RAD;
+  float dPsi = (-17.20f * sin(node) - 1.32f * sin(sun) - 0.23f * sin(moon) + 0.21f * sin(2 * node)) * ARCSECONDS_TO_RADIANS;
+  float dEps = (9.20f * cos(node) + 0.57f * cos(sun) + 0.10f * cos(moon) - 0.09f * cos(2 * node)) * ARCSECONDS_TO_RADIANS;
+  float eps = (84381.448f - 46.8150f * t) * ARCSECONDS_TO_RADIANS;
+
+  float cosZeta = cos(zeta), sinZeta = sin(zeta);
+  float cosZ = cos(z), sinZ = sin(z);
+  float cosTheta = cos(theta), sinTheta = sin(theta);
+  float precession[3][3] = {
+    { cosZeta * cosZ * cosTheta - sinZeta * sinZ, -sinZeta * cosZ * cosTheta - cosZeta * sinZ, -cosZ * sinTheta },
+    { cosZeta * sinZ * cosTheta + sinZeta * cosZ, -sinZeta * sinZ * cosTheta + cosZeta * cosZ, -sinZ * sinTheta },
+    { cosZeta * sinTheta, -sinZeta * sinTheta, cosTheta },
+  };
+
+  // Nutation angles are small, so its rotation is 1 plus a skew matrix
+  float cosEps = dPsi * cos(eps), sinEps = dPsi * sin(eps);
+  float nutation[3][3] = {
+    { 1, -cosEps, -sinEps },
+    { cosEps, 1, -dEps },
+    { sinEps, dEps, 1 },
+  };
+
+  for (byte row = 0; row < 3; row++)
+  {
+    for (byte col = 0; col < 3; col++)
+    {
+      _matrix[row][col] = nutation[row][0] * precession[0][col] + nutation[row][1] * precession[1][col] + nutation[row][2] * precession[2][col];
+    }
+  }
+
+  _hour = hour;
+  _valid = true;
+  LOGV2(DEBUG_MOUNT, "Precession: Updated rotation for %l hours after J2000", hour);
+}
+
+// Rotate the position by the matrix, or by its transpose (the inverse rotation)
+void Precession::rotate(Angle& ra, Angle& dec, bool inverse) const
+{
+  float raRadians = ra.signedDegrees() * DEG_TO_RAD;
+  float decRadians = dec.signedDegrees() * DEG_TO_RAD;
+  float in[3] = { cos(decRadians) * cos(raRadians), cos(decRadians) * sin(raRadians), sin(decRadians) };
+  float out[3];
+  for (byte row = 0; row < 3; row++)
+  {
+    out[row] = 0;
+    for (byte col = 0; col < 3; col++)
+    {
+      out[row] += (inverse ? _matrix[col][row] : _matrix[row][col]) * in[col];
+    }
+  }
+
+  ra = Angle::fromDegrees(atan2(out[1], out[0]) * RAD_TO_DEG);
+  dec = Angle::fromDegrees(atan2(out[2], sqrt(out[0] * out[0] + out[1] * out[1])) * RAD_TO_DEG);
+}
+
+#endif
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Configuration_adv.hpp"
+#include "Angle.hpp"
+#include "Sidereal.hpp"
+
+#if EPOCH_CONVERSION == 1
+
+//////////////////////////////////////////////////////////////////
+//
+// Conversion between J2000 coordinates and the equator and equinox of date (JNow).
+//
+// Precession (IAU 1976) and the main terms of nutation are combined into one rotation matrix.
+// Between them they move a position by up to ~50" a year, while the matrix changes by less than
+// a second of arc a day. So the matrix is only recomputed when the date is EPOCH_UPDATE_HOURS
+// away from the one it was computed for, and a conversion is a matrix multiply and two inverse trig calls.
+// The result is good to about a second of arc.
+//////////////////////////////////////////////////////////////////
+class Precession {
+public:
+  Precession();
+
+  // Convert J2000 ra and dec (-90 to 90) to the equator and equinox of the given date.
+  void toDate(const JulianDate& date, Angle& ra, Angle& dec);
+
+  // Convert ra and dec (-90 to 90) of the given date to J2000.
+  void toJ2000(const JulianDate& date, Angle& ra, Angle& dec);
+
+private:
+  void update(const JulianDate& date);
+  void rotate(Angle& ra, Angle& dec, bool inverse) const;
+
+  float _matrix[3][3];
+  long _hour;         // Hours since J2000.0 the matrix was computed for
+  bool _valid;
+};
+
+#endif
@@ -1,50 +1,83 @@
-#if USE_GPS == 1
 #include "Sidereal.hpp"
 
-// Constants for sidereal calculation       
-// Source: http://www.stargazing.net/kepler/altaz.html
-#define C1              100.46
-#define C2              0.985647
-#define C3              15.0
-#define C4              -0.5125
-#define J2000           2000
-
-static DayTime Sidereal::calculateByGPS(TinyGPSPlus* gps){
-    DayTime timeUTC = DayTime(gps->time.hour(), gps->time.minute(), gps->time.second());
-    //DayTime timeUTC = DayTime(14, 24, 11);
-    int deltaJd = calculateDeltaJd(gps->date.year(), gps->date.month(), gps->date.day());
-    //int deltaJd = calculateDeltaJd(2020, 7, 15);
-    double deltaJ = deltaJd + ((timeUTC.getTotalHours()) / 24.0);
-    return DayTime((float)(calculateTheta(deltaJ, gps->location.lng(), timeUTC.getTotalHours()) / 15.0));
-    //return DayTime((float)(calculateTheta(deltaJ, 8.487581, timeUTC.getTotalHours()) / 15.0));
-    }
+#define MS_PER_DAY              86400000UL
+// 2000-01-01 00:00 in days since 1970-01-01
+#define J2000_CIVIL_DAYS        10957L
+
+// GMST at J2000.0 (18.697374558h) as a fraction of a turn, x 2^32
+#define GMST_AT_J2000           3346025510UL
+// Sidereal turns per solar day beyond one (1.002737909350795 - 1), x 2^48
+#define SIDEREAL_EXCESS_Q48     770652970751LL
+// Sidereal turns per millisecond (1.002737909350795 / 86400000), x 2^63
+#define SIDEREAL_PER_MS_Q63     107044268442ULL
+// Angle units (2^-32 turn) per second of time
+#define ANGLE_PER_SECOND        49710.2696f
 
-static const double Sidereal::calculateTheta(double deltaJ, double longitude, float timeUTC){
-    double theta = C1;
-    theta += C2 * deltaJ;
-    theta += C3 * timeUTC;
-    theta += C4;
-    theta += longitude;
-    return fmod(theta, 360.0);
+// Days since 1970-01-01 of a Gregorian date, valid for all years
+static long civilDays(int year, int month, int day)
+{
+    year -= month <= 2;
+    long era = (year >= 0 ? year : year - 399) / 400;
+    long yearOfEra = year - era * 400;
+    long dayOfYear = (153L * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    long dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097L + dayOfEra - 719468L;
 }
 
-static const int Sidereal::calculateDeltaJd(int year, int month, int day){
-    const int daysInMonth[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+JulianDate Sidereal::julianDate(int year, int month, int day, int hour, int minute, int second)
+{
+    JulianDate date;
+    date.days = civilDays(year, month, day) - J2000_CIVIL_DAYS - 1;
+    // Midnight is halfway into the Julian day that started at the previous noon
+    date.msOfDay = MS_PER_DAY / 2;
+    advance(date, 1000UL * (3600L * hour + 60L * minute + second));
+    return date;
+}
 
-    // Calculating days without leapdays
-    long int deltaJd = (year - J2000) * 365 + day; 
-    for (int i=0; i < month - 1; i++){
-        deltaJd += daysInMonth[i];
+JulianDate Sidereal::buildDate()
+{
+    // __DATE__ is "Mmm dd yyyy"
+    const char* date = __DATE__;
+    const char* months = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    int month = 1;
+    while ((month < 12) && (strncmp(months + 3 * (month - 1), date, 3) != 0)) {
+        month++;
     }
+    return julianDate(atoi(date + 7), month, atoi(date + 4), 0, 0, 0);
+}
 
-    // Add leapdays
-    if (month <= 2){
-        // Not counting current year if we have not passed february yet
-        year--;
+void Sidereal::advance(JulianDate& date, unsigned long ms)
+{
+    date.days += ms / MS_PER_DAY;
+    date.msOfDay += ms % MS_PER_DAY;
+    if (date.msOfDay >= MS_PER_DAY) {
+        date.msOfDay -= MS_PER_DAY;
+        date.days++;
     }
-    deltaJd += year / 4 - year / 100 + year / 400;
-    deltaJd -= J2000 / 4 - J2000 / 100 + J2000 / 400;
-    return deltaJd; 
 }
 
-#endif // USE_GPS
+Angle Sidereal::gmst(const JulianDate& date)
+{
+    // Whole days only add the excess over one turn. The angle wraps at a full turn by overflowing.
+    uint32_t angle = GMST_AT_J2000;
+    angle += (uint32_t)(((int64_t)date.days * SIDEREAL_EXCESS_Q48) >> 16);
+    angle += (uint32_t)(((uint64_t)date.msOfDay * SIDEREAL_PER_MS_Q63) >> 31);
+
+    // Quadratic term, 0.093104s x T^2 with T in Julian centuries
+    float centuries = (date.days + 1.0f * date.msOfDay / MS_PER_DAY) / 36525.0f;
+    angle += (int32_t)(0.093104f * centuries * centuries * ANGLE_PER_SECOND);
+    return Angle::fromRaw(angle);
+}
+
+Angle Sidereal::lst(const JulianDate& date, float longitude)
+{
+    return gmst(date) + Angle::fromDegrees(longitude);
+}
+
+#if USE_GPS == 1
+DayTime Sidereal::calculateByGPS(TinyGPSPlus* gps)
+{
+    JulianDate date = julianDate(gps->date.year(), gps->date.month(), gps->date.day(), gps->time.hour(), gps->time.minute(), gps->time.second());
+    return lst(date, gps->location.lng()).toDayTime();
+}
+#endif
@@ -1,21 +1,47 @@
-#if USE_GPS == 1
-
 #pragma once
 
-#include <math.h>
-#include <TinyGPS++.h>
-
+#include <Arduino.h>
+#include "Configuration_adv.hpp"
 #include "DayTime.hpp"
+#include "Angle.hpp"
 
+#if USE_GPS == 1
+#include <TinyGPS++.h>
+#endif
+
+// A UT instant as whole days since J2000.0 (2000-01-01 12:00 UT) plus the milliseconds into that day.
+// Both parts are integers, so advancing it by a millis() delta never loses precision.
+struct JulianDate {
+  long days;
+  unsigned long msOfDay;      // 0 - 86399999, days start at noon like the Julian Date
+};
 
+//////////////////////////////////////////////////////////////////
+//
+// Sidereal time from a Julian date, without floating point.
+//
+// GMST is the IAU 1982 expression, evaluated as an integer day term plus a fraction of day term so
+// that the 24 bit float of the AVR boards never sees the full Julian date. UT1-UTC (< 0.9s) is ignored.
+//////////////////////////////////////////////////////////////////
 class Sidereal
 {
  public:
-    static DayTime calculateByGPS(TinyGPSPlus* gps);
+    // Convert a UT calendar date and time (Gregorian) to a JulianDate.
+    static JulianDate julianDate(int year, int month, int day, int hour, int minute, int second);
 
- private:
-    static const double calculateTheta(double deltaJ, double longitude, float timeUTC);
-    static const int calculateDeltaJd(int year, int month, int day);
-};
+    // Midnight UT of the day the firmware was compiled, for until the actual date is set.
+    static JulianDate buildDate();
+
+    // Move the date forward by the given number of milliseconds.
+    static void advance(JulianDate& date, unsigned long ms);
+
+    // Greenwich mean sidereal time at the given date.
+    static Angle gmst(const JulianDate& date);
 
+    // Local mean sidereal time at the given date and longitude (degrees, east positive).
+    static Angle lst(const JulianDate& date, float longitude);
+
+#if USE_GPS == 1
+    static DayTime calculateByGPS(TinyGPSPlus* gps);
 #endif
+};
@@ -0,0 +1,164 @@
+#include "TMC2209Driver.hpp"
+
+#if RA_DRIVER_TYPE == TMC2209_UART || DEC_DRIVER_TYPE == TMC2209_UART
+#include "Utility.hpp"
+
+#define TMC2209_SYNC        0x05
+#define TMC2209_WRITE       0x80
+#define TMC2209_GSTAT       0x01  // Write 1 to clear, so repeated writes are not redundant
+#define TMC2209_DATAGRAM    8
+#define TMC2209_FCLK        12000000.0f  // Internal clock, TSTEP and TPWMTHRS are counted in these
+#define TMC2209_TSTEP_MAX   0xFFFFF
+
+TMC2209Driver::TMC2209Driver(HardwareSerial* serial, float rsense, byte driverAddress)
+  : TMC2209Stepper(serial, rsense, driverAddress)
+{
+  _serial = serial;
+  _driverAddress = driverAddress;
+  _microsteps = 0;
+  _numRegisters = 0;
+  _queueHead = 0;
+  _queueCount = 0;
+}
+
+/////////////////////////////////
+//
+// write
+//
+/////////////////////////////////
+void TMC2209Driver::write(uint8_t address, uint32_t value)
+{
+  byte index = 0;
+  while ((index < _numRegisters) && (_registers[index].address != address)) {
+    index++;
+  }
+
+  if (index == _numRegisters) {
+    if (_numRegisters == TMC2209_REGISTER_CACHE_SIZE) {
+      // Can't shadow this one, send it right away.
+      LOGV2(DEBUG_MOUNT, "TMC2209: Register cache full, sending %x directly", address);
+      sendDatagram(address, value);
+      return;
+    }
+    _numRegisters++;
+    _registers[index].address = address;
+    _registers[index].pending = false;
+  }
+  else if ((_registers[index].value == value) && (address != TMC2209_GSTAT)) {
+    // Register already has (or is about to get) this value.
+    return;
+  }
+
+  _registers[index].value = value;
+  if (!_registers[index].pending) {
+    _registers[index].pending = true;
+    _queue[(_queueHead + _queueCount) % TMC2209_REGISTER_CACHE_SIZE] = index;
+    _queueCount++;
+  }
+}
+
+/////////////////////////////////
+//
+// process
+//
+/////////////////////////////////
+void TMC2209Driver::process()
+{
+  while ((_queueCount > 0) && (_serial->availableForWrite() >= TMC2209_DATAGRAM)) {
+    RegisterShadow& reg = _registers[_queue[_queueHead]];
+    _queueHead = (_queueHead + 1) % TMC2209_REGISTER_CACHE_SIZE;
+    _queueCount--;
+    reg.pending = false;
+    sendDatagram(reg.address, reg.value);
+  }
+}
+
+/////////////////////////////////
+//
+// flush
+//
+/////////////////////////////////
+void TMC2209Driver::flush()
+{
+  while (_queueCount > 0) {
+    process();
+  }
+}
+
+/////////////////////////////////
+//
+// isBusy
+//
+/////////////////////////////////
+bool TMC2209Driver::isBusy() const
+{
+  return _queueCount > 0;
+}
+
+/////////////////////////////////
+//
+// microsteps
+//
+/////////////////////////////////
+void TMC2209Driver::microsteps(uint16_t ms)
+{
+  _microsteps = ms;
+  TMC2209Stepper::microsteps(ms);
+}
+
+uint16_t TMC2209Driver::microsteps() const
+{
+  return _microsteps;
+}
+
+/////////////////////////////////
+//
+// setSpreadCycleSpeed
+//
+/////////////////////////////////
+// The driver uses StealthChop while TSTEP (time between two 1/256 microsteps) is at least TPWMTHRS.
+void TMC2209Driver::setSpreadCycleSpeed(float fullStepsPerSecond)
+{
+  uint32_t threshold = 0;
+  if (fullStepsPerSecond > 0) {
+    float tstep = TMC2209_FCLK / (fullStepsPerSecond * 256.0f);
+    threshold = (tstep >= TMC2209_TSTEP_MAX) ? TMC2209_TSTEP_MAX : (uint32_t)tstep;
+  }
+
+  LOGV3(DEBUG_MOUNT, "TMC2209: SpreadCycle above %f fullsteps/s, TPWMTHRS is %l", fullStepsPerSecond, threshold);
+  en_spreadCycle(false);
+  TPWMTHRS(threshold);
+}
+
+/////////////////////////////////
+//
+// sendDatagram
+//
+/////////////////////////////////
+// Write access datagram as described in the TMC2209 datasheet, section 4.1.1.
+void TMC2209Driver::sendDatagram(uint8_t address, uint32_t value)
+{
+  uint8_t datagram[TMC2209_DATAGRAM] = {
+    TMC2209_SYNC, _driverAddress, (uint8_t)(address | TMC2209_WRITE),
+    (uint8_t)(value >> 24), (uint8_t)(value >> 16), (uint8_t)(value >> 8), (uint8_t)value, 0
+  };
+
+  uint8_t crc = 0;
+  for (byte i = 0; i < TMC2209_DATAGRAM - 1; i++) {
+    uint8_t currentByte = datagram[i];
+    for (byte j = 0; j < 8; j++) {
+      if ((crc >> 7) ^ (currentByte & 0x01)) {
+        crc = (crc << 1) ^ 0x07;
+      }
+      else {
+        crc = (crc << 1);
+      }
+      currentByte >>= 1;
+    }
+  }
+  datagram[TMC2209_DATAGRAM - 1] = crc;
+
+  _serial->write(datagram, TMC2209_DATAGRAM);
+}
+
+#endif
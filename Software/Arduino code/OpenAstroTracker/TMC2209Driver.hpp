@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Configuration_adv.hpp"
+
+#if RA_DRIVER_TYPE == TMC2209_UART || DEC_DRIVER_TYPE == TMC2209_UART
+#include <TMCStepper.h>
+
+// Number of distinct registers that are shadowed. The TMC2209 has 14 writable registers.
+#define TMC2209_REGISTER_CACHE_SIZE 14
+
+//////////////////////////////////////////////////////////////////
+//
+// TMC2209 driver that does not block on register writes.
+//
+// TMCStepper sends each register write as an 8 byte datagram and then waits for the
+// driver's reply delay. At 57600 baud that stalls the caller for ~3.5ms, which is what
+// startSlewingToTarget(), guidePulse() and stopGuiding() paid for every microsteps() call.
+//
+// This class takes over the library's register write. Every written value is kept in a
+// shadow table. Writing the value a register already has (or is about to get) is skipped,
+// a second write to a register that is still waiting to be sent replaces the waiting value.
+// Waiting writes are sent in order by process() whenever the serial TX buffer has room,
+// so the bytes are clocked out by the UART interrupt in the background.
+//
+// The driver is wired write-only (TX only), so the shadows are never read back.
+//////////////////////////////////////////////////////////////////
+class TMC2209Driver : public TMC2209Stepper {
+public:
+  TMC2209Driver(HardwareSerial* serial, float rsense, byte driverAddress);
+
+  // Send waiting register writes while the serial port can take them. Call often from the main loop.
+  void process();
+
+  // Block until all waiting register writes have been handed to the serial port.
+  void flush();
+
+  // Whether there are register writes waiting to be sent.
+  bool isBusy() const;
+
+  // Set the microstep mode. Hides the TMCStepper version so the mode can be read back
+  // without a UART read (the driver is wired write-only).
+  void microsteps(uint16_t ms);
+  uint16_t microsteps() const;
+
+  // Run in StealthChop below the given speed and in SpreadCycle above it by programming TPWMTHRS.
+  // Speed is in full motor steps per second, 0 keeps StealthChop at all speeds.
+  void setSpreadCycleSpeed(float fullStepsPerSecond);
+
+protected:
+  // Called by TMCStepper for every register write.
+  virtual void write(uint8_t address, uint32_t value) override;
+
+private:
+  struct RegisterShadow {
+    uint8_t address;
+    bool pending;
+    uint32_t value;
+  };
+
+  void sendDatagram(uint8_t address, uint32_t value);
+
+  HardwareSerial* _serial;
+  byte _driverAddress;
+  uint16_t _microsteps;
+  RegisterShadow _registers[TMC2209_REGISTER_CACHE_SIZE];
+  byte _numRegisters;
+
+  // FIFO of indexes into _registers that are waiting to be sent.
+  byte _queue[TMC2209_REGISTER_CACHE_SIZE];
+  byte _queueHead;
+  byte _queueCount;
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include "Configuration_adv.hpp"
+
+#if TRAJECTORY_FOLLOWING == 1
+#include "Trajectory.hpp"
+
+Trajectory::Trajectory()
+{
+  clear();
+}
+
+void Trajectory::clear()
+{
+  _first = 0;
+  _count = 0;
+}
+
+bool Trajectory::add(unsigned long time, float raSteps, float decSteps)
+{
+  if ((_count == TRAJECTORY_POINTS) || ((_count > 0) && (time <= point(_count - 1).time)))
+  {
+    return false;
+  }
+
+  Waypoint& waypoint = _points[(_first + _count) % TRAJECTORY_POINTS];
+  waypoint.time = time;
+  waypoint.ra = raSteps;
+  waypoint.dec = decSteps;
+  _count++;
+  return true;
+}
+
+byte Trajectory::count() const
+{
+  return _count;
+}
+
+bool Trajectory::position(unsigned long time, float& raSteps, float& decSteps)
+{
+  if (_count == 0)
+  {
+    return false;
+  }
+  if (time <= point(0).time)
+  {
+    raSteps = point(0).ra;
+    decSteps = point(0).dec;
+    return true;
+  }
+  if (time >= point(_count - 1).time)
+  {
+    return false;
+  }
+
+  // Find the segment, then drop the waypoints before the one its start tangent needs
+  byte segment = 0;
+  while (point(segment + 1).time <= time)
+  {
+    segment++;
+  }
+  if (segment > 1)
+  {
+    _first = (_first + segment - 1) % TRAJECTORY_POINTS;
+    _count -= segment - 1;
+    segment = 1;
+  }
+
+  const Waypoint& start = point(segment);
+  const Waypoint& end = point(segment + 1);
+  float raStart, decStart, raEnd, decEnd;
+  tangent(segment, raStart, decStart);
+  tangent(segment + 1, raEnd, decEnd);
+
+  // Hermite basis functions
+  float length = end.time - start.time;
+  float s = (time - start.time) / length;
+  float s2 = s * s;
+  float s3 = s2 * s;
+  float h00 = 2 * s3 - 3 * s2 + 1;
+  float h10 = (s3 - 2 * s2 + s) * length;
+  float h01 = 3 * s2 - 2 * s3;
+  float h11 = (s3 - s2) * length;
+
+  raSteps = h00 * start.ra + h10 * raStart + h01 * end.ra + h11 * raEnd;
+  decSteps = h00 * start.dec + h10 * decStart + h01 * end.dec + h11 * decEnd;
+  return true;
+}
+
+const Trajectory::Waypoint& Trajectory::point(byte index) const
+{
+  return _points[(_first + index) % TRAJECTORY_POINTS];
+}
+
+// Steps per millisecond at the waypoint, from its neighbours. The first and last waypoints only have one.
+void Trajectory::tangent(byte index, float& ra, float& dec) const
+{
+  const Waypoint& before = point(index > 0 ? index - 1 : index);
+  const Waypoint& after = point(index < _count - 1 ? index + 1 : index);
+  float length = after.time - before.time;
+  ra = (after.ra - before.ra) / length;
+  dec = (after.dec - before.dec) / length;
+}
+
+#endif
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Configuration_adv.hpp"
+
+#if TRAJECTORY_FOLLOWING == 1
+
+//////////////////////////////////////////////////////////////////
+//
+// Time-tagged path of the RA and DEC steppers, for following satellites and other fast movers.
+//
+// The waypoints are kept in a ring, so a client can keep adding waypoints ahead of the mount while
+// the ones it has passed are dropped. Between waypoints the position is a cubic Hermite spline with
+// Catmull-Rom tangents, which only needs the waypoints on either side of the segment and so works on
+// a path that is still being streamed. The spline passes through every waypoint and its speed is continuous.
+//////////////////////////////////////////////////////////////////
+class Trajectory {
+public:
+  Trajectory();
+
+  // Forget all waypoints.
+  void clear();
+
+  // Add a waypoint at the given time (milliseconds). Returns false if the ring is full or the time is not
+  // after the last waypoint.
+  bool add(unsigned long time, float raSteps, float decSteps);
+
+  // Number of waypoints stored.
+  byte count() const;
+
+  // Get the stepper positions at the given time. Before the first waypoint it is the first waypoint.
+  // Returns false once the time is past the last waypoint.
+  bool position(unsigned long time, float& raSteps, float& decSteps);
+
+private:
+  struct Waypoint {
+    unsigned long time;
+    float ra;
+    float dec;
+  };
+
+  const Waypoint& point(byte index) const;
+  void tangent(byte index, float& ra, float& dec) const;
+
+  Waypoint _points[TRAJECTORY_POINTS];
+  byte _first;
+  byte _count;
+};
+
+#endif
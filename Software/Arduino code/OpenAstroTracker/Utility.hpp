@@ -133,6 +133,7 @@ void logv(int levelFlags, const char* input, ...);
 #define LOGV5(level,a,b,c,d,e) 
 #define LOGV6(level,a,b,c,d,e,f) 
 #define LOGV7(level,a,b,c,d,e,f,g)
+#define LOGV8(level,a,b,c,d,e,f,g,h)
 
 #endif // DEBUG_LEVEL>0
 
@@ -7,6 +7,7 @@
 #include "LcdMenu.hpp"
 #include "Utility.hpp"
 #include "EPROMStore.hpp"
+#include "FastTrig.hpp"
 //#include "Sidereal.hpp"
 
 LcdMenu lcdMenu(16, 2, MAXMENUITEMS);
@@ -138,6 +139,10 @@ void setup() {
 
   LOGV2(DEBUG_ANY, "Hello, universe, this is OAT %s!", version.c_str());
 
+  #if FAST_TRIG == 1 && FAST_TRIG_TIMING == 1 && defined(__AVR__)
+  FastTrig::reportTiming();
+  #endif
+
   EPROMStore::initialize();
 
   /////////////////////////////////
@@ -223,12 +228,11 @@ void finishSetup()
     mount.configureAltStepper(FULLSTEP, ALTmotorPin1, ALTmotorPin2, ALTmotorPin3, ALTmotorPin4, ALTITUDE_MAX_SPEED, ALTITUDE_MAX_ACCEL);
   #endif
 
-  // The mount uses EEPROM storage locations 0-10 that it reads during construction
-  // The LCD uses EEPROM storage location 11
+  // The mount and the LCD keep their settings in the EEPROM config (see ConfigData)
   mount.readConfiguration();
   
   // Read other persisted values and set in mount
-  DayTime haTime = DayTime(EPROMStore::Storage()->read(1), EPROMStore::Storage()->read(2), 0);
+  DayTime haTime = DayTime(EPROMStore::Storage()->config().haHours, EPROMStore::Storage()->config().haMinutes, 0);
 
   LOGV2(DEBUG_INFO, "SpeedCal: %s", String(mount.getSpeedCalibration(), 5).c_str());
   LOGV2(DEBUG_INFO, "TRKSpeed: %s", String(mount.getSpeed(TRACKING), 5).c_str());
@@ -244,6 +248,11 @@ void finishSetup()
   // Start the tracker.
   mount.startSlewing(TRACKING);
 
+  #if POSITION_CHECKPOINT == 1 && (HEADLESS_CLIENT == 1 || SUPPORT_GUIDED_STARTUP == 0)
+    // No startup wizard to ask, so carry on where we were if the mount lost power.
+    mount.resumeFromCheckpoint();
+  #endif
+
   #if HEADLESS_CLIENT == 0
     // Create the LCD top-level menu items
     lcdMenu.addItem("RA", RA_Menu);
@@ -9,7 +9,9 @@
 //////////////////////////////////////////////////////////////
 // This file contains the Starup 'wizard' that guides you through initial setup
 
+#define StartupCheckForResume 0
 #define StartupIsInHomePosition 1
+#define StartupResumePosition 2
 #define StartupSetHATime 4
 #define StartupWaitForHACompletion 6
 #define StartupHAConfirmed 7
@@ -21,16 +23,19 @@
 #define NO 2
 #define CANCEL 3
 
-int startupState = StartupIsInHomePosition;
+int startupState = StartupCheckForResume;
 int isInHomePosition = NO;
+int resumePosition = YES;
 
-void startupIsCompleted() {
+void startupIsCompleted(bool startTracking = true) {
   LOGV1(DEBUG_INFO, "STARTUP: Completed!");
 
   startupState = StartupCompleted;
   inStartup = false;
 
-  mount.startSlewing(TRACKING);
+  if (startTracking) {
+    mount.startSlewing(TRACKING);
+  }
 
   // Start on the RA menu
   lcdMenu.setActive(RA_Menu);
@@ -41,6 +46,42 @@ bool processStartupKeys() {
   byte key;
   bool waitForRelease = false;
   switch (startupState) {
+    case StartupCheckForResume: {
+      #if POSITION_CHECKPOINT == 1
+      if (mount.hasPositionCheckpoint()) {
+        startupState = StartupResumePosition;
+        break;
+      }
+      mount.discardCheckpoint();
+      #endif
+      startupState = StartupIsInHomePosition;
+    }
+    break;
+
+    #if POSITION_CHECKPOINT == 1
+    case StartupResumePosition: {
+      if (lcdButtons.keyChanged(&key))
+      {
+        waitForRelease = true;
+        if (key == btnLEFT) {
+          resumePosition = adjustWrap(resumePosition, 1, YES, NO);
+        }
+        else if (key == btnSELECT) {
+          if (resumePosition == YES) {
+            // The checkpoint restores tracking too, so don't restart it.
+            mount.resumeFromCheckpoint();
+            startupIsCompleted(false);
+          }
+          else {
+            mount.discardCheckpoint();
+            startupState = StartupIsInHomePosition;
+          }
+        }
+      }
+    }
+    break;
+    #endif
+
     case StartupIsInHomePosition: {
       if (lcdButtons.keyChanged(&key))
       {
@@ -116,6 +157,16 @@ bool processStartupKeys() {
     }
     break;
 
+    #if RA_DRIVER_TYPE == TMC2209_UART && USE_AUTOHOME == 1
+    case StartupWaitForPoleCompletion: {
+      // Autohome runs from the mount loop, continue with the HA once it is done.
+      if (!mount.isFindingHome()) {
+        startupState = StartupSetHATime;
+      }
+    }
+    break;
+    #endif
+
     case StartupPoleConfirmed: {
       isInHomePosition = YES;
 
@@ -131,6 +182,27 @@ bool processStartupKeys() {
 
 void printStartupMenu() {
   switch (startupState) {
+    #if POSITION_CHECKPOINT == 1
+    case StartupResumePosition: {
+      //              0123456789012345
+      String choices(" Yes  No        ");
+      if (resumePosition == YES) {
+        choices.setCharAt(0, '>');
+        choices.setCharAt(4, '<');
+      }
+      else {
+        choices.setCharAt(5, '>');
+        choices.setCharAt(8, '<');
+      }
+
+      lcdMenu.setCursor(0, 0);
+      lcdMenu.printMenu("Resume position?");
+      lcdMenu.setCursor(0, 1);
+      lcdMenu.printMenu(choices);
+    }
+    break;
+    #endif
+
     case StartupIsInHomePosition: {
       //              0123456789012345
       String choices(" Yes  No  Cancl ");
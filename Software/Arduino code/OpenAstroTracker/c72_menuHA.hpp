@@ -35,8 +35,9 @@ bool processHAKeys() {
       break;
 
       case btnSELECT: {
-        EPROMStore::Storage()->update(1, mount.HA().getHours());
-        EPROMStore::Storage()->update(2, mount.HA().getMinutes());
+        EPROMStore::Storage()->config().haHours = mount.HA().getHours();
+        EPROMStore::Storage()->config().haMinutes = mount.HA().getMinutes();
+        EPROMStore::Storage()->configChanged();
         lcdMenu.printMenu("Stored.");
         mount.delay(500);
 
@@ -41,10 +41,14 @@ bool gpsAqcuisitionComplete()
                 int mHAfromLST = lst.getMinutes() - PolarisRAMinute;
                 mount.setHA(DayTime(hHAfromLST, mHAfromLST, 0));
 
-                EPROMStore::Storage()->update(1, mount.HA().getHours());
-                EPROMStore::Storage()->update(2, mount.HA().getMinutes());
+                EPROMStore::Storage()->config().haHours = mount.HA().getHours();
+                EPROMStore::Storage()->config().haMinutes = mount.HA().getMinutes();
+                EPROMStore::Storage()->configChanged();
                 mount.setLatitude(gps.location.lat());
                 mount.setLongitude(gps.location.lng());
+                #if EPOCH_CONVERSION == 1
+                mount.setDate(gps.date.year(), gps.date.month(), gps.date.day());
+                #endif
 
                 mount.delay(500);
 
@@ -108,8 +112,9 @@ bool processHAKeys()
             if (key == btnSELECT)
             {
                 DayTime ha(mount.HA());
-                EPROMStore::Storage()->update(1, mount.HA().getHours());
-                EPROMStore::Storage()->update(2, mount.HA().getMinutes());
+                EPROMStore::Storage()->config().haHours = mount.HA().getHours();
+                EPROMStore::Storage()->config().haMinutes = mount.HA().getMinutes();
+                EPROMStore::Storage()->configChanged();
                 lcdMenu.printMenu("Stored.");
                 mount.delay(500);
                 haState = SHOWING_HA_SET;
@@ -10,6 +10,12 @@ bool setZeroPoint = true;
 byte loopsWithKeyPressed = 0;
 byte keyPressed = btnNONE;
 
+#if MANUAL_SLEW_HOLD_ACCELERATE == 1
+// Holding a button starts at the slowest slew rate and speeds up. The rate from before is restored after the slew.
+int rateBeforeHold = 0;
+unsigned long lastRateChange = 0;
+#endif
+
 
 bool processKeyStateChanges(int key, int dir)
 {
@@ -22,6 +28,17 @@ bool processKeyStateChanges(int key, int dir)
     if (loopsWithKeyPressed == LOOPS_TO_CONFIRM_KEY) {
       mount.stopSlewing(ALL_DIRECTIONS);
       mount.waitUntilStopped(ALL_DIRECTIONS);
+#if MANUAL_SLEW_HOLD_ACCELERATE == 1
+      if (rateBeforeHold != 0) {
+        mount.setSlewRate(rateBeforeHold);
+        rateBeforeHold = 0;
+      }
+      if (dir != 0) {
+        rateBeforeHold = mount.getSlewRate();
+        mount.setSlewRate(1);
+        lastRateChange = millis();
+      }
+#endif
       if (dir != 0) {
         mount.startSlewing(dir);
       }
@@ -31,6 +48,13 @@ bool processKeyStateChanges(int key, int dir)
     else if (loopsWithKeyPressed < LOOPS_TO_CONFIRM_KEY) {
       loopsWithKeyPressed++;
     }
+#if MANUAL_SLEW_HOLD_ACCELERATE == 1
+    else if ((dir != 0) && (mount.getSlewRate() < 4) && (millis() - lastRateChange > MANUAL_SLEW_HOLD_TIME)) {
+      // The stepper ramps up to the faster rate with that rate's acceleration
+      mount.setSlewRate(mount.getSlewRate() + 1);
+      lastRateChange = millis();
+    }
+#endif
   }
   
   return ret;
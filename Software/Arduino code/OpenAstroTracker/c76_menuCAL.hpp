@@ -24,25 +24,26 @@
 #if GYRO_LEVEL == 1
 #define HIGHLIGHT_ROLL_LEVEL 9
 #define HIGHLIGHT_PITCH_LEVEL 10
-#define HIGHLIGHT_LAST 10
+#define HIGHLIGHT_PROFILE 11
 #else
-#define HIGHLIGHT_LAST 8
+#define HIGHLIGHT_PROFILE 9
 #endif
 #else
 #if GYRO_LEVEL == 1
 #define HIGHLIGHT_ROLL_LEVEL 7
 #define HIGHLIGHT_PITCH_LEVEL 8
-#define HIGHLIGHT_LAST 8
+#define HIGHLIGHT_PROFILE 9
 #else
-#define HIGHLIGHT_LAST 6
+#define HIGHLIGHT_PROFILE 7
 #endif
 #endif
+#define HIGHLIGHT_LAST HIGHLIGHT_PROFILE
 
-// Polar calibration goes through these three states:
-//  11- moving to RA and DEC beyond Polaris and waiting on confirmation that Polaris is centered
+// Polar calibration goes through these two states:
+//  12- moving to RA and DEC beyond Polaris and waiting on confirmation that Polaris is centered
 //  13- moving back to home position
-#define POLAR_CALIBRATION_WAIT_CENTER_POLARIS 11
-#define POLAR_CALIBRATION_WAIT_HOME 12
+#define POLAR_CALIBRATION_WAIT_CENTER_POLARIS 12
+#define POLAR_CALIBRATION_WAIT_HOME 13
 
 // Speed calibration only has one state, allowing you to adjust the speed with UP and DOWN
 #define SPEED_CALIBRATION 14
@@ -78,6 +79,9 @@
 // Pitch Offset Calibration only has one state, allowing you to set the current pitch angle as level
 #define PITCH_OFFSET_CALIBRATION 23
 
+// Profile selection only has one state, allowing you to pick a profile with UP and DOWN and switch to it with SELECT
+#define PROFILE_SELECTION 24
+
 // Start off with Polar Alignment higlighted.
 byte calState = HIGHLIGHT_FIRST;
 
@@ -100,6 +104,9 @@ int BacklashSteps = 0;
 int AzimuthMinutes = 0;
 int AltitudeMinutes = 0;
 
+// The profile that is shown while selecting one.
+byte ProfileIndex = 0;
+
 // Pitch and roll offset
 #if GYRO_LEVEL == 1
 float PitchCalibrationAngle = 0.0;
@@ -107,6 +114,11 @@ float RollCalibrationAngle = 0.0;
 bool gyroStarted = false;
 #endif
 
+#if GYRO_LEVEL == 1 && AZIMUTH_ALTITUDE_MOTORS == 1 && AUTO_LEVEL == 1
+// Whether the levelling was started from this menu, levelling started with :XVS# is left running.
+bool calLevelling = false;
+#endif
+
 #if AZIMUTH_ATLITUDE_MOTORS == 1
 bool azAltMotorsEnabled = false;
 #endif
@@ -118,14 +130,30 @@ void gotoNextMenu()
 {
   lcdMenu.setNextActive();
 
+  bool keepAzAltMotors = false;
+#if GYRO_LEVEL == 1 && AZIMUTH_ALTITUDE_MOTORS == 1 && AUTO_LEVEL == 1
+  if (calLevelling)
+  {
+    mount.stopLevelling();
+    calLevelling = false;
+  }
+  keepAzAltMotors = (mount.getLevellingState() == LEVEL_RUNNING);
+#endif
+
 #if AZIMUTH_ALTITUDE_MOTORS == 1
-  mount.disableAzAltMotors();
+  if (!keepAzAltMotors)
+  {
+    mount.disableAzAltMotors();
+  }
   azAltMotorsStarted = false;
 #endif
 
 #if GYRO_LEVEL == 1
-  Gyro::shutdown();
-  gyroStarted = false;
+  if (gyroStarted)
+  {
+    Gyro::shutdown();
+    gyroStarted = false;
+  }
 #endif
 }
 
@@ -174,6 +202,10 @@ void gotoNextHighlightState(int dir)
   {
     BacklashSteps = mount.getBacklashCorrection();
   }
+  else if (calState == HIGHLIGHT_PROFILE)
+  {
+    ProfileIndex = mount.getProfile();
+  }
   else if (calState == HIGHLIGHT_SPEED)
   {
     SpeedCalibration = (mount.getSpeedCalibration() - 1.0) * 10000.0 + 0.5;
@@ -509,8 +541,25 @@ bool processCalibrationKeys()
         LOGV2(DEBUG_INFO, "CAL: Set pitch to %f", angles.pitchAngle);
         calState = HIGHLIGHT_PITCH_LEVEL;
       }
+#if AZIMUTH_ALTITUDE_MOTORS == 1 && AUTO_LEVEL == 1
+      else if (key == btnUP)
+      {
+        // Drive the altitude motor until the pitch is back at the offset
+        mount.startLevelling();
+        calLevelling = true;
+      }
+      else if (key == btnDOWN)
+      {
+        mount.stopLevelling();
+        calLevelling = false;
+      }
+#endif
       else if (key == btnLEFT)
       {
+#if AZIMUTH_ALTITUDE_MOTORS == 1 && AUTO_LEVEL == 1
+        mount.stopLevelling();
+        calLevelling = false;
+#endif
         calState = HIGHLIGHT_PITCH_LEVEL;
       }
       else if (key == btnRIGHT)
@@ -521,6 +570,41 @@ bool processCalibrationKeys()
     }
     break;
 #endif
+    case PROFILE_SELECTION:
+    {
+      if (key == btnDOWN)
+      {
+        ProfileIndex = adjustWrap(ProfileIndex, 1, 0, CONFIG_PROFILES - 1);
+      }
+      else if (key == btnUP)
+      {
+        ProfileIndex = adjustWrap(ProfileIndex, -1, 0, CONFIG_PROFILES - 1);
+      }
+      else if (key == btnSELECT)
+      {
+        if (mount.selectProfile(ProfileIndex))
+        {
+          lcdMenu.printMenu("Profile active.");
+        }
+        else
+        {
+          lcdMenu.printMenu("Park mount first");
+        }
+        mount.delay(500);
+        calState = HIGHLIGHT_PROFILE;
+      }
+      else if (key == btnLEFT)
+      {
+        calState = HIGHLIGHT_PROFILE;
+      }
+      else if (key == btnRIGHT)
+      {
+        gotoNextMenu();
+        calState = HIGHLIGHT_PROFILE;
+      }
+    }
+    break;
+
       // case BACKLIGHT_CALIBRATION:
       // {
       //   // UP and DOWN are handled above
@@ -555,6 +639,9 @@ bool processCalibrationKeys()
         // Set DEC to move the same distance past Polaris as
         // it is from the Celestial Pole. That equates to 88deg 42' 11.2".
         mount.targetDEC() = DegreeTime(88 - (NORTHERN_HEMISPHERE ? 90 : -90), 42, 11);
+        #if EPOCH_CONVERSION == 1
+        mount.dateToEpoch(mount.targetRA(), mount.targetDEC());
+        #endif
         mount.startSlewingToTarget();
       }
       else if (key == btnRIGHT)
@@ -572,9 +659,17 @@ bool processCalibrationKeys()
         lcdMenu.printMenu("Aligned, homing");
         mount.delay(750);
 
-        // Sync the mount to Polaris, since that's where it's pointing
-        DayTime currentRa = mount.currentRA();
-        mount.syncPosition(currentRa.getHours(), currentRa.getMinutes(), currentRa.getSeconds(), 89 - (NORTHERN_HEMISPHERE ? 90 : -90), 21, 6);
+        // Sync the mount to Polaris, since that's where it's pointing. The mount was just realigned,
+        // so the old pointing model no longer applies and the sync has to set the position.
+        #if POINTING_MODEL == 1
+        mount.clearPointingModel();
+        #endif
+        DayTime polarisRA(PolarisRAHour, PolarisRAMinute, PolarisRASecond);
+        DegreeTime polarisDEC(89 - (NORTHERN_HEMISPHERE ? 90 : -90), 21, 6);
+        #if EPOCH_CONVERSION == 1
+        mount.dateToEpoch(polarisRA, polarisDEC);
+        #endif
+        mount.syncPosition(polarisRA.getHours(), polarisRA.getMinutes(), polarisRA.getSeconds(), polarisDEC.getHours(), polarisDEC.getMinutes(), polarisDEC.getSeconds());
 
         // Go home from here
         mount.setTargetToHome();
@@ -765,6 +860,22 @@ bool processCalibrationKeys()
     break;
 #endif
 
+    case HIGHLIGHT_PROFILE:
+    {
+      if (key == btnDOWN)
+        gotoNextHighlightState(1);
+      if (key == btnUP)
+        gotoNextHighlightState(-1);
+      else if (key == btnSELECT)
+        calState = PROFILE_SELECTION;
+      else if (key == btnRIGHT)
+      {
+        gotoNextMenu();
+        calState = HIGHLIGHT_FIRST;
+      }
+    }
+    break;
+
       // case HIGHLIGHT_BACKLIGHT : {
       //   if (key == btnDOWN) gotoNextHighlightState(1);
       //   if (key == btnUP) gotoNextHighlightState(-1);
@@ -846,6 +957,10 @@ void printCalibrationSubmenu()
     lcdMenu.printMenu(">Pitch Offset");
   }
 #endif
+  else if (calState == HIGHLIGHT_PROFILE)
+  {
+    lcdMenu.printMenu(">Mount profile");
+  }
   // else if (calState == HIGHLIGHT_BACKLIGHT) {
   //   lcdMenu.printMenu(">LCD Brightness");
   // }
@@ -910,10 +1025,23 @@ void printCalibrationSubmenu()
   {
     auto angles = Gyro::getCurrentAngles();
     sprintf(scratchBuffer, "P: -------------");
+#if AZIMUTH_ALTITUDE_MOTORS == 1 && AUTO_LEVEL == 1
+    if (mount.getLevellingState() == LEVEL_RUNNING)
+    {
+      scratchBuffer[0] = 'L';
+    }
+#endif
     makeIndicator(scratchBuffer, angles.pitchAngle - PitchCalibrationAngle);
     lcdMenu.printMenu(scratchBuffer);
   }
 #endif
+  else if (calState == PROFILE_SELECTION)
+  {
+    // Profiles that are not in use yet are created when selected
+    String name = mount.getProfileName(ProfileIndex);
+    sprintf(scratchBuffer, "%c%d: %s", (ProfileIndex == mount.getProfile()) ? '*' : ' ', ProfileIndex + 1, name.length() ? name.c_str() : "(new)");
+    lcdMenu.printMenu(scratchBuffer);
+  }
   // else if (calState == BACKLIGHT_CALIBRATION) {
   //   sprintf(scratchBuffer, "Brightness: %d", Brightness);
   //   lcdMenu.printMenu(scratchBuffer);
@@ -3,11 +3,32 @@
 #if HEADLESS_CLIENT == 0
 
 #if SUPPORT_INFO_DISPLAY == 1
+#if GYRO_LEVEL == 1
+#include "Gyro.hpp"
+#endif
+
 byte infoIndex = 0;
 byte maxInfoIndex = 7;
 byte subIndex = 0;
 unsigned long lastInfoUpdate = 0;
 
+#if GYRO_LEVEL == 1
+// The gyro is only started while the temperature is shown
+bool infoGyroStarted = false;
+
+void showInfoTemperature(bool show) {
+  if (show != infoGyroStarted) {
+    if (show) {
+      Gyro::startup();
+    }
+    else {
+      Gyro::shutdown();
+    }
+    infoGyroStarted = show;
+  }
+}
+#endif
+
 bool processStatusKeys() {
   byte key;
   bool waitForRelease = false;
@@ -36,6 +57,9 @@ bool processStatusKeys() {
       }
       break;
     }
+#if GYRO_LEVEL == 1
+    showInfoTemperature((infoIndex == 4) && (key != btnRIGHT));
+#endif
   }
 
   return waitForRelease;
@@ -96,10 +120,15 @@ void printStatusSubmenu() {
 
       case 4: {
         #if GYRO_LEVEL == 1
-        int celsius = (int)round(Gyro::getCurrentTemperature());
-        int fahrenheit = (int)round(32.0 + 9.0 * Gyro::getCurrentTemperature() / 5.0);
-
-        sprintf(scratchBuffer, "Temp: %d@C %d@F", celsius, fahrenheit);
+        showInfoTemperature(true);
+        if (Gyro::hasSample()) {
+          int celsius = (int)round(Gyro::getCurrentTemperature());
+          int fahrenheit = (int)round(32.0 + 9.0 * Gyro::getCurrentTemperature() / 5.0);
+          sprintf(scratchBuffer, "Temp: %d@C %d@F", celsius, fahrenheit);
+        }
+        else {
+          sprintf(scratchBuffer, "Temp: --@C --@F");
+        }
         lcdMenu.printMenu(scratchBuffer);
         #else
         infoIndex++;